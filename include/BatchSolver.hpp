@@ -0,0 +1,88 @@
+//
+//  BatchSolver.hpp
+//
+
+#pragma once
+
+#include <atomic> // std::atomic
+#include <memory> // std::shared_ptr
+#include <random> // std::default_random_engine, std::uniform_real_distribution
+#include <vector>
+
+#include "CosineBasis.hpp"
+#include "D2Fourier.hpp"
+#include "D2Gauss.hpp"
+#include "ThreadPool.hpp"
+
+
+/**
+ * @brief class BatchSolver solves f_b''(x) = g_b(x) for many RHS g_b
+ * sharing one CosineBasis. All targets are advanced in lockstep, and
+ * coefficients, mode weights and residuals are stored in
+ * structure-of-arrays layout (index [k*B + b] resp. [i*B + b] for B
+ * targets), so that every pass over a basis column serves the whole batch.
+ * Target b follows exactly the same path as
+ * StochasticSolver(seed + b).solve(..., basis, lr) would.
+ */
+class BatchSolver
+{
+    public:
+        /**
+         * @brief Default constructor, uses seed=1.
+         */
+        BatchSolver();
+
+        /**
+         * @brief Constructor.
+         * Target b uses a random engine seeded with seed + b.
+         */
+        BatchSolver(int);
+
+        /**
+         * @brief Solves f_b''(x) = g_b(x) for all targets b.
+         * Throws std::invalid_argument if d2f and g differ in size or a
+         * solution does not have basis.n() coefficients.
+         * @param d2f initial solutions, one per target; updated in place
+         * @param g RHS of all targets
+         * @param m number of iterations in stochastic solver, int
+         * @param basis precomputed Fourier-(cos)modes, defines n and N
+         * @param lr initial learning rate of every target, double
+         * @return D2Fourier solution objects, one per target
+         */
+        std::vector<D2Fourier> solve(const std::vector<std::shared_ptr<D2Fourier>>&,
+                                     const std::vector<std::shared_ptr<D2Gauss>>&,
+                                     int, const CosineBasis&, double);
+
+        /**
+         * @brief Setter for the thread pool used to split the node range
+         * of each batched distance evaluation. Pass nullptr to evaluate serially.
+         * @param pool shared pointer to ThreadPool
+         */
+        void set_thread_pool(std::shared_ptr<ThreadPool>);
+
+        /**
+         * @brief Request a running solve to return early. If no solve
+         * is running, the request applies to the next one.
+         * May be called from any thread.
+         */
+        void cancel();
+
+    private:
+        /**
+         * @brief Computes the distances of all targets in one pass over the basis.
+         * @param basis Fourier-(cos)modes
+         * @param w mode weights, [k*B + b]
+         * @param g sampled RHS, [i*B + b]
+         * @param B number of targets
+         * @param d output distances, B values
+         */
+        void distances(const CosineBasis&, const double*, const double*, int, double*);
+
+        int _seed; // seed of target 0
+        std::uniform_real_distribution<double> _dist; // distribution for step
+        std::shared_ptr<ThreadPool> _pool; // optional thread pool for distance evaluation
+        std::atomic<bool> _cancel; // _cancel == true -> solve returns early
+        std::vector<double> _partial; // per chunk sums of distances(), [j*B + b]
+        std::vector<double> _p; // per chunk sums of one target
+        static const int lanes = 8; // targets whose residuals distances() keeps in registers
+};
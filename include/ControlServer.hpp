@@ -0,0 +1,59 @@
+//
+//  ControlServer.hpp
+//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "SolverControl.hpp"
+
+
+/**
+ * @brief class ControlServer listens on a Unix-domain socket and lets
+ * local clients (e.g. socat or nc -U) query and steer a running solve
+ * through a SolverControl. The protocol is line based, one reply line
+ * per request line:
+ * stats -> "iteration <i> accepted <a> distance <d> lr <lr> paused <0|1> running <0|1> overlap <s>"
+ * coefficients -> "<c_0> <c_1> ... <c_(n-1)>"
+ * pause, resume, stop, lr <value> -> "ok"
+ * checkpoint [<path>] -> "ok <path>", writes stats and coefficients to path
+ * Unknown or malformed requests -> "error <reason>".
+ * Stats and coefficients are those of the last poll of the solver.
+ */
+class ControlServer
+{
+    public:
+        /**
+         * @brief Constructor.
+         * @param path path of the socket; an existing socket is replaced,
+         * any other existing file makes operator() fail
+         * @param control mailboxes of the solve to be controlled
+         */
+        ControlServer(std::string path, std::shared_ptr<SolverControl> control);
+
+        /**
+         * @brief Serve clients, one at a time, until stop() is called.
+         * Implement operator() in order to be able to
+         * start new threads with function objects.
+         */
+        void operator()();
+
+        /**
+         * @brief Stops serving; operator() returns within 100 ms.
+         */
+        void stop();
+
+    private:
+        /**
+         * @brief Handle one request line.
+         * @return reply line without newline
+         */
+        std::string handle(const std::string& line);
+
+        std::string _path; // socket path
+        std::shared_ptr<SolverControl> _control; // mailboxes of solve
+        std::atomic<bool> _run; // _run == false -> stop serving
+};
@@ -0,0 +1,134 @@
+//
+//  CosineBasis.hpp
+//
+
+#pragma once
+
+#include <memory> // std::shared_ptr
+#include <vector>
+
+#include "Function.hpp"
+#include "ThreadPool.hpp"
+
+
+/**
+ * @brief class CosineBasis stores the Fourier-(cos)modes cos(k*x_i),
+ * k = 0, ..., n-1, sampled at the N nodes x_i of the (centered) Riemann
+ * rule on [a, b], see MathUtil::Integrator::simple.
+ * The table is stored mode by mode, i.e. column k holds cos(k*x_i)
+ * for all i contiguously.
+ * Building the table once removes all cos() calls from the
+ * distance evaluations in StochasticSolver::solve.
+ * The tables are read-only after construction and shared between copies;
+ * TableCache can provide them from a memory-mapped file instead.
+ */
+class CosineBasis
+{
+    public:
+        /**
+         * @brief Constructor. Builds the node and mode tables.
+         * @param n number of Fourier coefficients
+         * @param N number of discrete intervals for numeric integration
+         * @param a lower integration boundary
+         * @param b upper integration boundary
+         */
+        CosineBasis(int n, int N, double a, double b);
+
+        /**
+         * @brief Getter for number of Fourier coefficients.
+         */
+        int n() const;
+
+        /**
+         * @brief Getter for number of discrete intervals.
+         */
+        int N() const;
+
+        /**
+         * @brief Getter for lower integration boundary.
+         */
+        double a() const;
+
+        /**
+         * @brief Getter for upper integration boundary.
+         */
+        double b() const;
+
+        /**
+         * @brief Getter for width of one discrete interval, i.e. the
+         * quadrature weight of every node.
+         */
+        double dx() const;
+
+        /**
+         * @brief Pointer to nodes x_i, i = 0, ..., N-1.
+         */
+        const double* nodes() const;
+
+        /**
+         * @brief Pointer to column k, i.e. cos(k*x_i) for i = 0, ..., N-1.
+         * @param k mode index
+         */
+        const double* column(int k) const;
+
+        /**
+         * @brief Sample function f at all nodes.
+         * @param f function to be sampled
+         * @return vector of f(x_i)
+         */
+        std::vector<double> sample(const Function& f) const;
+
+        /**
+         * @brief Compute residual r_i = sum_k w_k cos(k*x_i) - g_i
+         * at all nodes.
+         * @param w mode weights (n values), c_k*lambda_k, see D2Fourier::get_multipliers
+         * @param g sampled RHS (N values)
+         * @param r output residual (N values)
+         * @param pool optional ThreadPool, used for large N
+         */
+        void residual(const double* w, const double* g, double* r, ThreadPool* pool = nullptr) const;
+
+        /**
+         * @brief Update a residual after changing the weights of modes
+         * k_begin, ..., k_end-1 only, i.e.
+         * r_new_i = r_i + sum_{k=k_begin}^{k_end-1} dw_k cos(k*x_i).
+         * Costs O(N*(k_end - k_begin)) instead of O(N*n) for residual().
+         * @param r residual of the old weights (N values)
+         * @param k_begin first changed mode
+         * @param k_end one past last changed mode
+         * @param dw weight changes (k_end - k_begin values)
+         * @param r_new output residual (N values), may equal r
+         * @param pool optional ThreadPool, used for large N
+         */
+        void update(const double* r, int k_begin, int k_end, const double* dw, double* r_new,
+                    ThreadPool* pool = nullptr) const;
+
+        /**
+         * @brief Compute L2 norm sqrt(int_a^b r^2) of a residual,
+         * see MathUtil::Distance::L2.
+         * @param r residual (N values)
+         * @param pool optional ThreadPool, used for large N
+         */
+        double l2(const double* r, ThreadPool* pool = nullptr) const;
+
+    private:
+        friend class TableCache;
+
+        /**
+         * @brief Constructor from existing tables, used by TableCache.
+         * @param storage keeps x and table alive
+         * @param x nodes (N values)
+         * @param table modes (n*N values)
+         */
+        CosineBasis(int n, int N, double a, double b,
+                    std::shared_ptr<const void> storage, const double* x, const double* table);
+
+        int _n; // number of Fourier coefficients
+        int _N; // number of discrete intervals
+        double _a; // lower integration boundary
+        double _b; // upper integration boundary
+        double _dx; // width of one discrete interval
+        std::shared_ptr<const void> _storage; // owner of _x and _table
+        const double* _x; // nodes
+        const double* _table; // cos(k*x_i), column k at offset k*N
+};
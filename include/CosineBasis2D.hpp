@@ -0,0 +1,75 @@
+//
+//  CosineBasis2D.hpp
+//
+
+#pragma once
+
+#include <vector>
+
+#include "CosineBasis.hpp"
+#include "Function2D.hpp"
+#include "ThreadPool.hpp"
+
+
+/**
+ * @brief class CosineBasis2D provides the tensor-product modes
+ * cos(k*x_i) cos(l*y_j) on the N x N node grid of the square [a, b]^2.
+ * Since the modes factorize, only one CosineBasis per axis is stored
+ * (both axes share it), and sum_k,l w_kl cos(k*x_i) cos(l*y_j) is
+ * evaluated as two small matrix products, T = W C and C^T T, in
+ * O(n*n*N + n*N*N) instead of O(n*n*N*N).
+ * Grid values are stored row by row, (x_i, y_j) at index i*N + j.
+ */
+class CosineBasis2D
+{
+    public:
+        /**
+         * @brief Constructor. Builds the per-axis table.
+         * @param n number of Fourier modes per axis
+         * @param N number of discrete intervals per axis
+         * @param a lower integration boundary (both axes)
+         * @param b upper integration boundary (both axes)
+         */
+        CosineBasis2D(int n, int N, double a, double b);
+
+        /**
+         * @brief Getter for per-axis basis.
+         */
+        const CosineBasis& axis() const;
+
+        /**
+         * @brief Getter for number of Fourier modes per axis.
+         */
+        int n() const;
+
+        /**
+         * @brief Getter for number of discrete intervals per axis.
+         */
+        int N() const;
+
+        /**
+         * @brief Sample function f at all grid nodes.
+         * @param f function to be sampled
+         * @return vector of f(x_i, y_j), N*N values
+         */
+        std::vector<double> sample(const Function2D& f) const;
+
+        /**
+         * @brief Compute residual r_ij = sum_k,l w_kl cos(k*x_i) cos(l*y_j) - g_ij.
+         * @param w mode weights (n*n values, w_kl at k*n + l), e.g. c_kl*lambda_kl
+         * @param g sampled RHS (N*N values)
+         * @param r output residual (N*N values)
+         * @param pool optional ThreadPool, used for large N
+         */
+        void residual(const double* w, const double* g, double* r, ThreadPool* pool = nullptr) const;
+
+        /**
+         * @brief Compute L2 norm sqrt(int int r^2 dx dy) of a residual.
+         * @param r residual (N*N values)
+         * @param pool optional ThreadPool, used for large N
+         */
+        double l2(const double* r, ThreadPool* pool = nullptr) const;
+
+    private:
+        CosineBasis _axis; // modes along one axis
+};
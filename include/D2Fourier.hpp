@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "Function.hpp"
+#include "LinearOperator.hpp"
 
 
 /**
@@ -14,6 +15,9 @@
  * of a Fourier-(cos)series.
  * Second derivative of Fourier-(cos)series sum_k=0^(n-1) c_k cos(k*x) is 
  * sum_k=0^(n-1) c_k (-k*k) cos(k*x).
+ * More generally, any LinearOperator L can be applied instead of the
+ * second derivative, giving sum_k=0^(n-1) c_k lambda_k cos(k*x) with
+ * the multipliers lambda_k of L.
  * Inherits from Function.
  */
 class D2Fourier : public Function
@@ -23,7 +27,8 @@ class D2Fourier : public Function
          * @brief Default constructor.
          * Initialize members to:
          * _c = {} (empty vector),
-         * _n = 0.
+         * _n = 0,
+         * _op = d^2/dx^2.
          */
         D2Fourier();
 
@@ -33,6 +38,13 @@ class D2Fourier : public Function
          */
         D2Fourier(std::vector<double>);
 
+        /**
+         * @brief Constructor with initializer list.
+         * @param c Vector of coefficients
+         * @param op Operator applied to the Fourier-(cos)series
+         */
+        D2Fourier(std::vector<double>, LinearOperator);
+
         /**
          * @brief Getter for coefficients vector _c.
          * @return _c Vector of coefficients
@@ -45,6 +57,18 @@ class D2Fourier : public Function
          */
         void set_coefficients(const std::vector<double>);
 
+        /**
+         * @brief Getter for operator _op.
+         */
+        LinearOperator get_operator() const;
+
+        /**
+         * @brief Getter for multipliers lambda_k of _op, k = 0, ..., n-1.
+         * Solvers combine them with the coefficients into the mode
+         * weights c_k*lambda_k used by CosineBasis.
+         */
+        const std::vector<double>& get_multipliers() const;
+
         /**
          * @brief Evaluate second derivative of Fourier-(cos)series at position x.
          * @param x Position
@@ -61,4 +85,6 @@ class D2Fourier : public Function
     private:
         std::vector<double> _c; // vector for Fourier coefficients
         int _n; // number of Fourier coefficients
+        LinearOperator _op; // operator applied to Fourier-(cos)series
+        std::vector<double> _m; // multipliers of _op
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+//
+//  D2Fourier2D.hpp
+//
+
+#pragma once
+
+#include <vector>
+
+#include "Function2D.hpp"
+#include "LinearOperator.hpp"
+
+
+/**
+ * @brief class D2Fourier2D represents the Laplacian of a tensor-product
+ * Fourier-(cos)series f(x,y) = sum_k,l=0^(n-1) c_kl cos(k*x) cos(l*y),
+ * i.e. sum_k,l=0^(n-1) c_kl (-k*k - l*l) cos(k*x) cos(l*y).
+ * As for D2Fourier, another LinearOperator can be applied instead,
+ * giving the multipliers lambda_kl of L.
+ * Coefficients are stored row by row, c_kl at index k*n + l.
+ * Inherits from Function2D.
+ */
+class D2Fourier2D : public Function2D
+{
+    public:
+        /**
+         * @brief Default constructor.
+         * Initialize members to:
+         * _c = {} (empty vector),
+         * _n = 0,
+         * _op = Laplacian.
+         */
+        D2Fourier2D();
+
+        /**
+         * @brief Constructor with initializer list.
+         * @param c Vector of n*n coefficients
+         */
+        D2Fourier2D(std::vector<double>);
+
+        /**
+         * @brief Constructor with initializer list.
+         * @param c Vector of n*n coefficients
+         * @param op Operator applied to the Fourier-(cos)series
+         */
+        D2Fourier2D(std::vector<double>, LinearOperator);
+
+        /**
+         * @brief Getter for coefficients vector _c.
+         * @return _c Vector of n*n coefficients
+         */
+        std::vector<double> get_coefficients() const;
+
+        /**
+         * @brief Setter for coefficients vector _c.
+         * Throws std::invalid_argument if the size of c is not a square.
+         * @param c Vector of n*n new coefficients
+         */
+        void set_coefficients(const std::vector<double>);
+
+        /**
+         * @brief Getter for number of modes per axis.
+         */
+        int get_n() const;
+
+        /**
+         * @brief Getter for multipliers lambda_kl of _op at index k*n + l.
+         */
+        const std::vector<double>& get_multipliers() const;
+
+        /**
+         * @brief Evaluate Laplacian of Fourier-(cos)series at position (x, y).
+         * Needs 2n cos calls, since the modes factorize.
+         * @param x Position along x
+         * @param y Position along y
+         * @return Function value
+         */
+        double operator() (double x, double y) const override;
+
+        Function2D* clone() const override;
+
+        std::string gnuplot_plot() const override;
+
+        std::string gnuplot_title() const override;
+
+    private:
+        /**
+         * @brief Set _n from size of _c and recompute _m.
+         * Throws std::invalid_argument if the size of _c is not a square.
+         */
+        void resize();
+
+        std::vector<double> _c; // vector for Fourier coefficients, n*n
+        int _n; // number of Fourier modes per axis
+        LinearOperator _op; // operator applied to Fourier-(cos)series
+        std::vector<double> _m; // multipliers of _op, n*n
+};
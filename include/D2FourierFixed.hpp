@@ -0,0 +1,166 @@
+//
+//  D2FourierFixed.hpp
+//
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <utility> // std::index_sequence
+
+#include "Function.hpp"
+#include "LinearOperator.hpp"
+
+
+/**
+ * @brief class template D2FourierFixed represents the second derivative
+ * of a Fourier-(cos)series with a mode count n fixed at compile time,
+ * i.e. sum_k=0^(n-1) c_k (-k*k) cos(k*x), see D2Fourier.
+ * Coefficients live in a std::array, the factors -k*k are constexpr and
+ * the mode weights c_k*(-k*k) are updated on set_coefficients.
+ * Another LinearOperator can be passed on construction; its multipliers
+ * then replace the factors -k*k at no extra cost per evaluation.
+ * Evaluation calls cos only once and obtains all other modes from the
+ * fully unrolled recurrence cos(k*x) = 2 cos(x) cos((k-1)*x) - cos((k-2)*x).
+ * Use D2Fourier if n is only known at runtime.
+ * Inherits from Function.
+ */
+template <int n>
+class D2FourierFixed : public Function
+{
+    static_assert(n >= 1, "D2FourierFixed needs at least one mode");
+
+    public:
+        /**
+         * @brief Default constructor.
+         * Initialize all coefficients to zero.
+         */
+        D2FourierFixed() : _c{}, _m(factors), _w{} {}
+
+        /**
+         * @brief Constructor with initializer list.
+         * @param c Array of coefficients
+         */
+        D2FourierFixed(const std::array<double, n>& c) : _m(factors)
+        {
+            set_coefficients(c);
+        }
+
+        /**
+         * @brief Constructor with initializer list.
+         * @param c Array of coefficients
+         * @param op Operator applied to the Fourier-(cos)series
+         */
+        D2FourierFixed(const std::array<double, n>& c, const LinearOperator& op) : _op(op)
+        {
+            for(int k = 0; k < n; k++)
+            {
+                _m[k] = _op.multiplier(k);
+            }
+            set_coefficients(c);
+        }
+
+        /**
+         * @brief Getter for coefficients array _c.
+         * @return _c Array of coefficients
+         */
+        std::array<double, n> get_coefficients() const
+        {
+            return _c;
+        }
+
+        /**
+         * @brief Setter for coefficients array _c.
+         * @param c Array of new coefficients
+         */
+        void set_coefficients(const std::array<double, n>& c)
+        {
+            _c = c;
+            for(int k = 0; k < n; k++)
+            {
+                _w[k] = _c[k] * _m[k];
+            }
+        }
+
+        /**
+         * @brief Getter for operator _op.
+         */
+        LinearOperator get_operator() const
+        {
+            return _op;
+        }
+
+        /**
+         * @brief Evaluate second derivative of Fourier-(cos)series at position x.
+         * @param x Position
+         * @return Function value
+         */
+        double operator() (double x) const override
+        {
+            return evaluate(x, std::make_index_sequence<(n > 2 ? n - 2 : 0)>());
+        }
+
+        Function* clone() const override
+        {
+            return new D2FourierFixed(*this);
+        }
+
+        std::string gnuplot_plot() const override
+        {
+            std::string s = "";
+            for(int k = 0; k < n; k++)
+            {
+                s += std::to_string(_c[k]) + " * (" + std::to_string(_m[k]) + ") * cos(" + std::to_string(k) + " * x)";
+                s += k < (n - 1) ? " + " : "";
+            }
+            return s;
+        }
+
+        std::string gnuplot_title() const override
+        {
+            std::string s = _op.gnuplot_title() + " with f(x) = {/Symbol S}@^{n-1}_{k=0} c_k cos(kx)";
+            return s;
+        }
+
+    private:
+        /**
+         * @brief Compute factors -k*k of second derivative at compile time.
+         */
+        static constexpr std::array<double, n> make_factors()
+        {
+            std::array<double, n> f{};
+            for(int k = 0; k < n; k++)
+            {
+                f[k] = -k*k;
+            }
+            return f;
+        }
+
+        /**
+         * @brief Recurrence kernel, unrolled over modes k = 2, ..., n-1
+         * by expanding the index sequence K = 0, ..., n-3.
+         */
+        template <std::size_t... K>
+        double evaluate(double x, std::index_sequence<K...>) const
+        {
+            double c1 = cos(x);
+            double two_c1 = 2 * c1;
+            double sum = _w[0];
+            if(n > 1)
+                sum += _w[n > 1 ? 1 : 0] * c1;
+            double t0 = 1.0; // cos((k-2)*x)
+            double t1 = c1; // cos((k-1)*x)
+            double t;
+            ((t = two_c1 * t1 - t0, sum += _w[K + 2] * t, t0 = t1, t1 = t), ...);
+            (void)t;
+            return sum;
+        }
+
+        static constexpr std::array<double, n> factors = make_factors(); // -k*k
+
+        std::array<double, n> _c; // array for Fourier coefficients
+        LinearOperator _op; // operator applied to Fourier-(cos)series
+        std::array<double, n> _m; // multipliers of _op
+        std::array<double, n> _w; // mode weights _c[k] * _m[k]
+};
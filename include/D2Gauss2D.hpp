@@ -0,0 +1,58 @@
+//
+// D2Gauss2D.hpp
+//
+
+#pragma once
+
+#include "Function2D.hpp"
+
+
+/**
+ * @brief class D2Gauss2D represents the Laplacian of a two-dimensional
+ * Gaussian a*exp(-k*((x-x0)^2 + (y-y0)^2)) with amplitude, kernel width
+ * and shift. With r^2 = (x-x0)^2 + (y-y0)^2 the Laplacian is
+ * a*exp(-k*r^2)*(-4*k + 4*k^2*r^2).
+ * Inherits from Function2D.
+ */
+class D2Gauss2D : public Function2D
+{
+    public:
+        /**
+         * @brief Default constructor.
+         * Initialize members to:
+         * _a = 1.0,
+         * _k = 1.0,
+         * _x0 = 0.0,
+         * _y0 = 0.0
+         */
+        D2Gauss2D();
+
+        /**
+         * @brief Constructor with initializer list.
+         * @param a Amplitude
+         * @param k Kernel width
+         * @param x0 Shift parameter along x
+         * @param y0 Shift parameter along y
+         */
+        D2Gauss2D(double, double, double, double);
+
+        /**
+         * @brief Evaluate Laplacian of Gaussian at position (x, y).
+         * @param x Position along x
+         * @param y Position along y
+         * @return Function value
+         */
+        double operator() (double x, double y) const override;
+
+        Function2D* clone() const override;
+
+        std::string gnuplot_plot() const override;
+
+        std::string gnuplot_title() const override;
+
+    private:
+        double _a; // amplitude
+        double _k; // kernel width
+        double _x0; // shift along x
+        double _y0; // shift along y
+};
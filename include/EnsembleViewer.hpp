@@ -0,0 +1,93 @@
+//
+//  EnsembleViewer.hpp
+//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Function.hpp"
+#include "LinearOperator.hpp"
+#include "SolverControl.hpp"
+
+
+/**
+ * @brief class EnsembleViewer monitors many concurrent solves in a single
+ * gnuplot process. Each solve publishes its state through a SolverControl
+ * (see StochasticSolver::set_control); the viewer is the controller side
+ * of these mailboxes and must not share them with a ControlServer.
+ * Every frame is one multiplot with a panel per solve (current solution
+ * vs. RHS) and a panel with the distance-vs-iteration curves of all
+ * solves. Frames are rate limited globally, skipped if no solve has
+ * published anything new, and sent to gnuplot in one write; the
+ * convergence curves are sampled at the frame rate.
+ */
+class EnsembleViewer
+{
+    public:
+        /**
+         * @brief Constructor.
+         * @param max_fps maximum number of frames per second
+         */
+        EnsembleViewer(double max_fps = 10.0);
+
+        /**
+         * @brief Add a solve to be monitored. May be called while running.
+         * @param label title of the solve
+         * @param control mailboxes the solve publishes to
+         * @param g RHS of the solve
+         * @param op operator of the solve
+         */
+        void add(std::string label, std::shared_ptr<SolverControl> control,
+                 std::shared_ptr<Function> g, LinearOperator op = LinearOperator());
+
+        /**
+         * @brief Handle gnuplot until stop() is called.
+         * Implement operator() in order to be able to
+         * start new threads with function objects.
+         */
+        void operator()();
+
+        /**
+         * @brief Stops plotting. May be called before operator() runs,
+         * which then returns right after opening gnuplot.
+         */
+        void stop();
+
+    private:
+        /**
+         * @brief State of one monitored solve.
+         */
+        struct Run
+        {
+            std::string label; // title of the solve
+            std::shared_ptr<SolverControl> control; // mailboxes of the solve
+            std::shared_ptr<Function> g; // RHS
+            LinearOperator op; // operator
+            long iteration; // iteration of last seen snapshot
+            std::vector<double> coefficients; // coefficients of last seen snapshot
+            std::vector<long> hist_iteration; // convergence curve, iterations
+            std::vector<double> hist_distance; // convergence curve, distances
+        };
+
+        /**
+         * @brief Read new snapshots of all solves.
+         * @return true if any solve published something new
+         */
+        bool update();
+
+        /**
+         * @brief Build the gnuplot commands of one frame.
+         */
+        std::string frame() const;
+
+        std::vector<Run> _runs; // monitored solves
+        std::mutex _mtx; // guards _runs
+        double _frame_ms; // minimum time between two frames
+        std::atomic<bool> _run; // _run == true -> keep running/plotting
+        static const size_t max_points = 2000; // maximum points per convergence curve
+};
@@ -0,0 +1,42 @@
+//
+//  Function2D.hpp
+//
+
+#pragma once
+
+#include <string>
+
+
+class Function2D
+{
+    public:
+        /**
+         * @brief Evaluate function at position (x, y)
+         * @param x Position along first axis
+         * @param y Position along second axis
+         * @return Function value
+         */
+        virtual double operator() (double x, double y) const = 0;
+
+        /**
+         * @brief Virtual copy constructor
+         * @return Pointer to copy of this
+         */
+        virtual Function2D* clone() const = 0;
+
+        /**
+         * @brief Virtual destructor.
+         * Every abstract class should have a virtual destructor.
+         */
+        virtual ~Function2D() {};
+
+        /**
+         * @brief Gnuplot command to splot current object (in x and y).
+         */
+        virtual std::string gnuplot_plot() const = 0;
+
+        /**
+         * @brief Gnuplot command to plot current object title.
+         */
+        virtual std::string gnuplot_title() const = 0;
+};
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "Function.hpp"
+#include "Function2D.hpp"
 
 
 class GnuplotFunctionViewer
@@ -20,6 +21,14 @@ class GnuplotFunctionViewer
          */
         GnuplotFunctionViewer(std::vector<std::shared_ptr<Function>> vec_s_ptr);
 
+        /**
+         * @brief Construct a new Gnuplot Function Viewer object in heat-map
+         * mode from vector of (shared) pointers to derived Function2D objects.
+         * Every function is drawn as heat map on [-pi, pi]^2 in its own panel.
+         * @param vec_s_ptr Vector of shared pointers of functions to be plotted
+         */
+        GnuplotFunctionViewer(std::vector<std::shared_ptr<Function2D>> vec_s_ptr);
+
         /**
          * @brief Handle Gnuplot to make animation during StochasticSolver::solve.
          * Plots all functions stored in _vec_s_ptr;
@@ -35,7 +44,9 @@ class GnuplotFunctionViewer
 
     private:
         std::vector<std::shared_ptr<Function>> _vec_s_ptr; // Vector of function pointers
+        std::vector<std::shared_ptr<Function2D>> _vec2d_s_ptr; // Vector of 2D function pointers (heat-map mode)
 
         bool _run; // _state == true -> keep running/plotting
         int _n; // size of vector of function pointers
+        bool _heatmap; // _heatmap == true -> plot _vec2d_s_ptr as heat maps
 };
\ No newline at end of file
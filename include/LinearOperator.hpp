@@ -0,0 +1,109 @@
+//
+//  LinearOperator.hpp
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief class LinearOperator represents a linear differential operator
+ * with constant coefficients and even derivatives only,
+ * L = sum_j a_j d^(2j)/dx^(2j).
+ * Applied to a Fourier-(cos)mode, L cos(k*x) = lambda_k cos(k*x) with
+ * the multiplier lambda_k = sum_j a_j (-k*k)^j, hence L acts diagonally
+ * on the coefficients of a Fourier-(cos)series.
+ * Examples:
+ * f'' = g: a = {0, 1}, lambda_k = -k*k,
+ * f'' + p*f = g: a = {p, 1}, lambda_k = p - k*k,
+ * f'''' = g: a = {0, 0, 1}, lambda_k = k^4,
+ * f'' - kappa^2*f = g (screened Poisson): a = {-kappa^2, 1}.
+ * In two dimensions, d^2/dx^2 is replaced by the Laplacian, i.e.
+ * L = sum_j a_j Laplace^j, and cos(k*x) cos(l*y) has the multiplier
+ * lambda_kl = sum_j a_j (-k*k - l*l)^j.
+ */
+class LinearOperator
+{
+    public:
+        /**
+         * @brief Default constructor.
+         * Initialize to second derivative d^2/dx^2, i.e. a = {0, 1}.
+         */
+        LinearOperator();
+
+        /**
+         * @brief Constructor with initializer list.
+         * @param a Coefficients a_j of d^(2j)/dx^(2j)
+         */
+        LinearOperator(std::vector<double>);
+
+        /**
+         * @brief Second derivative f''.
+         */
+        static LinearOperator second_derivative();
+
+        /**
+         * @brief Helmholtz operator f'' + p*f.
+         * @param p coefficient of f
+         */
+        static LinearOperator helmholtz(double);
+
+        /**
+         * @brief Screened Poisson operator f'' - kappa^2*f.
+         * @param kappa screening parameter
+         */
+        static LinearOperator screened_poisson(double);
+
+        /**
+         * @brief Fourth derivative f''''.
+         */
+        static LinearOperator fourth_derivative();
+
+        /**
+         * @brief Getter for coefficients vector _a.
+         * @return _a Coefficients a_j of d^(2j)/dx^(2j)
+         */
+        std::vector<double> get_coefficients() const;
+
+        /**
+         * @brief Multiplier lambda_k of mode cos(k*x).
+         * @param k mode index
+         */
+        double multiplier(int k) const;
+
+        /**
+         * @brief Multiplier lambda_kl of two-dimensional mode cos(k*x) cos(l*y).
+         * @param k mode index along x
+         * @param l mode index along y
+         */
+        double multiplier(int k, int l) const;
+
+        /**
+         * @brief Multipliers lambda_k of modes k = 0, ..., n-1.
+         * @param n number of modes
+         */
+        std::vector<double> multipliers(int n) const;
+
+        /**
+         * @brief Title of L applied to f, e.g. "d^2/dx^2 f(x) + 2 f(x)".
+         */
+        std::string gnuplot_title() const;
+
+        /**
+         * @brief Title of L applied to f in two dimensions, where
+         * d^(2j)/dx^(2j) becomes the j-th power of the Laplacian,
+         * e.g. "{/Symbol D} f(x,y) + 2 f(x,y)".
+         */
+        std::string gnuplot_title_2d() const;
+
+    private:
+        /**
+         * @brief Common part of gnuplot_title and gnuplot_title_2d.
+         * @param two_d true -> powers of the Laplacian applied to f(x,y)
+         */
+        std::string title(bool) const;
+
+        std::vector<double> _a; // coefficients a_j of d^(2j)/dx^(2j)
+};
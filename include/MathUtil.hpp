@@ -11,16 +11,102 @@
 #include <vector>
 
 #include "Function.hpp"
+#include "Function2D.hpp"
+#include "ThreadPool.hpp"
 
 
 namespace MathUtil
 {
+    /**
+     * @brief Deterministic summation of many terms.
+     * Small sums are accumulated serially (fast path). Large sums are
+     * split into chunks of fixed size, each chunk is accumulated with
+     * Kahan summation and the chunk results are combined pairwise.
+     * Since the chunking depends only on the number of terms, the result
+     * is bitwise identical for any number of threads (or no ThreadPool).
+     */
+    namespace Reduction
+    {
+        const int chunk_size = 1 << 12; // number of terms per chunk
+        const int parallel_threshold = 1 << 16; // minimum number of terms for chunking
+
+        /**
+         * @brief Kahan (compensated) summation of term(i) for i in [begin, end)
+         * @param term callable returning the i-th term
+         */
+        template <typename T>
+        inline double kahan(const T& term, int begin, int end)
+        {
+            double sum = 0.0;
+            double c = 0.0;
+            for(int i = begin; i < end; i++)
+            {
+                double y = term(i) - c;
+                double t = sum + y;
+                c = (t - sum) - y;
+                sum = t;
+            }
+            return sum;
+        }
+
+        /**
+         * @brief Pairwise (cascade) summation of v[0], ..., v[n-1]
+         */
+        inline double pairwise(const double* v, int n)
+        {
+            if(n <= 2)
+                return n == 0 ? 0.0 : (n == 1 ? v[0] : v[0] + v[1]);
+            int h = n / 2;
+            return pairwise(v, h) + pairwise(v + h, n - h);
+        }
+
+        /**
+         * @brief Sum of term(i) for i in [0, n).
+         * @param term callable returning the i-th term; must be safe
+         * to call concurrently from several threads
+         * @param n number of terms (int)
+         * @param pool optional ThreadPool to split the chunks over (ThreadPool*)
+         */
+        template <typename T>
+        inline double sum(const T& term, int n, ThreadPool* pool = nullptr)
+        {
+            if(n < parallel_threshold)
+            {
+                double s = 0.0;
+                for(int i = 0; i < n; i++)
+                {
+                    s += term(i);
+                }
+                return s;
+            }
+            int n_chunks = (n + chunk_size - 1) / chunk_size;
+            std::vector<double> partial(n_chunks);
+            auto chunk = [&term, &partial, n](int j)
+            {
+                partial[j] = kahan(term, j * chunk_size, std::min(n, (j + 1) * chunk_size));
+            };
+            if(pool)
+            {
+                pool->parallel_for(n_chunks, chunk);
+            }
+            else
+            {
+                for(int j = 0; j < n_chunks; j++)
+                {
+                    chunk(j);
+                }
+            }
+            return pairwise(partial.data(), n_chunks);
+        }
+    }
+
     /**
      * @brief Numerically integrate functions in range 
      * @param f integrand (Function, or std::function<double(double)>)
      * @param a lower integration boundary (double)
      * @param b upper integration boundary (double)
      * @param n number of discrete intervals (int)
+     * @param pool optional ThreadPool for large n (ThreadPool*)
      * @return definite integral (double)
      */
     namespace Integrator
@@ -29,15 +115,12 @@ namespace MathUtil
          * @brief Simple (centered) Riemann integrator
          * @param f integrand const std::function<double(double)>& 
          */
-        inline double simple(const std::function<double(double)>& f, double a, double b, int n)
+        inline double simple(const std::function<double(double)>& f, double a, double b, int n,
+                             ThreadPool* pool = nullptr)
         {
             double dx = (b - a) / n;
             double dx_2 = dx / 2;
-            double sum = 0.0;
-            for(int i = 0; i < n; i++)
-            {
-                sum += f(a + dx*i + dx_2);
-            }
+            double sum = Reduction::sum([&f, a, dx, dx_2](int i){ return f(a + dx*i + dx_2); }, n, pool);
             sum *= dx;
             return sum;
         }
@@ -47,28 +130,53 @@ namespace MathUtil
          * Calls simple(const std::function<double(double)>&, ...)
          * @param f integrand const Function&
          */
-        inline double simple(const Function& f, double a, double b, int n)
+        inline double simple(const Function& f, double a, double b, int n, ThreadPool* pool = nullptr)
+        {
+            return simple([&f](double x){ return f(x); }, a, b, n, pool);
+        }
+
+        /**
+         * @brief Simple (centered) Riemann integrator on the square [a, b]^2
+         * with n x n discrete intervals
+         * @param f integrand const std::function<double(double, double)>&
+         */
+        inline double simple2D(const std::function<double(double, double)>& f, double a, double b, int n,
+                               ThreadPool* pool = nullptr)
+        {
+            double dx = (b - a) / n;
+            double dx_2 = dx / 2;
+            double sum = Reduction::sum([&f, a, dx, dx_2, n](int t)
+                {
+                    int i = t / n;
+                    int j = t % n;
+                    return f(a + dx*i + dx_2, a + dx*j + dx_2);
+                }, n * n, pool);
+            sum *= dx * dx;
+            return sum;
+        }
+
+        /**
+         * @brief Simple (centered) Riemann integrator on the square [a, b]^2
+         * Calls simple2D(const std::function<double(double, double)>&, ...)
+         * @param f integrand const Function2D&
+         */
+        inline double simple2D(const Function2D& f, double a, double b, int n, ThreadPool* pool = nullptr)
         {
-            return simple([&f](double x){ return f(x); }, a, b, n);
+            return simple2D([&f](double x, double y){ return f(x, y); }, a, b, n, pool);
         }
 
         /**
          * @brief Composite Simpson's rule integrator
          * @param f integrand const std::function<double(double)>& 
          */
-        inline double simpson(const std::function<double(double)>& f, double a, double b, int n)
+        inline double simpson(const std::function<double(double)>& f, double a, double b, int n,
+                              ThreadPool* pool = nullptr)
         {
-            double s1 = 0;
-            double s2 = 0;
             double dx = (b - a) / n;
-            for (int j = 1; j <= (n / 2 - 1); j++)
-            {
-                s1 += f(a + 2 * j*dx);
-            }
-            for (int j = 1; j <= n / 2; j++)
-            {
-                s2 += f(a + (2 * j - 1)*dx);
-            }
+            double s1 = Reduction::sum([&f, a, dx](int i){ int j = i + 1; return f(a + 2 * j*dx); },
+                                       n / 2 - 1, pool);
+            double s2 = Reduction::sum([&f, a, dx](int i){ int j = i + 1; return f(a + (2 * j - 1)*dx); },
+                                       n / 2, pool);
             return (dx / 3 * (f(a) + (2 * s1) + (4 * s2) + f(b)));
         }
 
@@ -77,9 +185,9 @@ namespace MathUtil
          * Calls simpson(const std::function<double(double)>&, ...)
          * @param f integrand const Function&
          */
-        inline double simpson(const Function& f, double a, double b, double dx)
+        inline double simpson(const Function& f, double a, double b, int n, ThreadPool* pool = nullptr)
         {
-            return simpson([&f](double x){ return f(x); }, a, b, dx);
+            return simpson([&f](double x){ return f(x); }, a, b, n, pool);
         }
     }
 
@@ -90,6 +198,7 @@ namespace MathUtil
      * @param a lower boundary (double)
      * @param b upper boundary (double)
      * @param n number of discrete intervals (int)
+     * @param pool optional ThreadPool for large n (ThreadPool*)
      * @return definite integral (double)
      */
     namespace Distance
@@ -102,10 +211,11 @@ namespace MathUtil
          * using lambda expressions.
          * Not used in main program.
          */
-        inline double L1(const Function& f1, const Function& f2, double a, double b, int n)
+        inline double L1(const Function& f1, const Function& f2, double a, double b, int n,
+                         ThreadPool* pool = nullptr)
         {
             auto f = [&f1, &f2](double x){ return abs(f1(x) - f2(x)); };
-            return Integrator::simple(f, a, b, n);
+            return Integrator::simple(f, a, b, n, pool);
         }
 
         /**
@@ -116,10 +226,22 @@ namespace MathUtil
          * using lambda expressions.
          * Used in main program.
          */
-        inline double L2(const Function& f1, const Function& f2, double a, double b, int n)
+        inline double L2(const Function& f1, const Function& f2, double a, double b, int n,
+                         ThreadPool* pool = nullptr)
         {
             auto f = [&f1, &f2](double x){ return pow(f1(x) - f2(x), 2); };
-            return sqrt(Integrator::simple(f, a, b, n));
+            return sqrt(Integrator::simple(f, a, b, n, pool));
+        }
+
+        /**
+         * @brief Compute L2 distance sqrt(int int (f1 - f2)^2 dx dy)
+         * on the square [a, b]^2 with n x n discrete intervals.
+         */
+        inline double L2(const Function2D& f1, const Function2D& f2, double a, double b, int n,
+                         ThreadPool* pool = nullptr)
+        {
+            auto f = [&f1, &f2](double x, double y){ return pow(f1(x, y) - f2(x, y), 2); };
+            return sqrt(Integrator::simple2D(f, a, b, n, pool));
         }
 
         /**
@@ -0,0 +1,92 @@
+//
+//  ProposalPipeline.hpp
+//
+
+#pragma once
+
+#include <atomic>
+#include <random> // std::default_random_engine, std::uniform_real_distribution
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief class ProposalPipeline generates the random step vectors of a
+ * StochasticSolver ahead of time in a producer thread, so that drawing and
+ * normalizing them overlaps with the distance evaluation of the solve.
+ * Steps are handed over through a lock-free single-producer/single-consumer
+ * ring. The producer draws from a copy of the solver's engine in the same
+ * order as StochasticSolver::step would, and each slot carries the norm
+ * of its draws, so the solve consumes bitwise the same steps as without
+ * the pipeline. After every pop() the solver's engine is set to the state
+ * after the consumed step, as if the steps had been drawn serially.
+ */
+class ProposalPipeline
+{
+    public:
+        /**
+         * @brief Constructor. Starts the producer thread.
+         * @param gen engine of the solver, copied now and updated by pop()
+         * @param dist distribution of the step components
+         * @param sizes lengths of consecutive steps, repeated cyclically
+         * @param depth number of slots in the ring
+         */
+        ProposalPipeline(std::default_random_engine& gen,
+                         const std::uniform_real_distribution<double>& dist,
+                         std::vector<int> sizes, int depth);
+
+        /**
+         * @brief Destructor. Calls stop().
+         */
+        ~ProposalPipeline();
+
+        /**
+         * @brief Take the next step vector, scaled to L2-norm lr.
+         * Waits if the producer has not caught up yet.
+         * @param lr learning rate, i.e. magnitude of step vector
+         * @param dc step vector, resized to the length of the step
+         */
+        void pop(double lr, std::vector<double>& dc);
+
+        /**
+         * @brief Stops and joins the producer. Steps produced but not
+         * consumed are dropped.
+         */
+        void stop();
+
+        /**
+         * @brief Seconds of step generation that were hidden behind the
+         * evaluation, i.e. production time of the consumed steps minus
+         * the time pop() had to wait for the producer.
+         */
+        double overlap_gain() const;
+
+    private:
+        /**
+         * @brief One pre-generated step.
+         */
+        struct Slot
+        {
+            std::vector<double> d; // uniform draws
+            double norm; // L2-norm of d
+            double seconds; // time it took to produce this slot
+            std::default_random_engine gen; // engine state after this slot
+        };
+
+        /**
+         * @brief Producer loop.
+         */
+        void produce();
+
+        std::default_random_engine& _gen; // engine of the solver
+        std::default_random_engine _gen_producer; // engine used by producer
+        std::uniform_real_distribution<double> _dist; // distribution of step components
+        std::vector<int> _sizes; // cyclic step lengths
+        std::vector<Slot> _slots; // ring buffer
+        std::atomic<size_t> _head; // number of consumed slots, written by consumer
+        std::atomic<size_t> _tail; // number of produced slots, written by producer
+        std::atomic<bool> _run; // _run == false -> producer returns
+        std::thread _producer; // producer thread
+        double _produced; // production seconds of consumed slots
+        double _stalled; // seconds pop() waited for the producer
+};
@@ -0,0 +1,104 @@
+//
+//  SolverControl.hpp
+//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+
+/**
+ * @brief struct SolverStats is a snapshot of a running solve.
+ */
+struct SolverStats
+{
+    long iteration = 0; // current iteration
+    long accepted = 0; // number of accepted proposals
+    double distance = 0.0; // distance of current coefficients
+    double lr = 0.0; // current learning rate
+    bool running = false; // running == false -> solve has returned
+    double overlap = 0.0; // seconds of step generation hidden by the pipelined mode
+    std::vector<double> coefficients; // current coefficients
+};
+
+/**
+ * @brief class SolverControl connects a solve loop to a controller running
+ * in another thread (see ControlServer) through lock-free mailboxes.
+ * Requests (stop, pause, new learning rate) are atomics the solver reads;
+ * stats go through a triple buffer, so neither side ever blocks the other.
+ * The solver only looks at its mailboxes once every interval() iterations.
+ * There must be one solver thread and one controller thread at most.
+ */
+class SolverControl
+{
+    public:
+        /**
+         * @brief Constructor.
+         * @param interval number of iterations between two polls of the solver
+         */
+        SolverControl(int interval = 1000);
+
+        /**
+         * @brief Getter for number of iterations between two polls.
+         */
+        int interval() const;
+
+        // Solver side
+
+        /**
+         * @brief Publish a new snapshot of the solve.
+         */
+        void publish(long iteration, long accepted, double distance, double lr,
+                     const std::vector<double>& c, bool running, double overlap = 0.0);
+
+        /**
+         * @brief Whether the controller asked the solve to return.
+         */
+        bool stop_requested() const;
+
+        /**
+         * @brief Whether the controller asked the solve to pause.
+         */
+        bool pause_requested() const;
+
+        /**
+         * @brief Take learning rate requested by the controller.
+         * @return new learning rate, or NaN if none was requested
+         */
+        double take_lr();
+
+        // Controller side
+
+        /**
+         * @brief Latest published snapshot.
+         */
+        const SolverStats& snapshot();
+
+        /**
+         * @brief Ask the solve to return at its next poll.
+         */
+        void request_stop();
+
+        /**
+         * @brief Ask the solve to pause (true) or resume (false).
+         */
+        void request_pause(bool);
+
+        /**
+         * @brief Ask the solve to continue with learning rate lr.
+         */
+        void request_lr(double);
+
+    private:
+        int _interval; // iterations between two polls
+        std::atomic<bool> _stop; // stop request
+        std::atomic<bool> _pause; // pause request
+        std::atomic<double> _lr; // learning rate request, NaN if none
+
+        SolverStats _buffers[3]; // triple buffer of snapshots
+        std::atomic<int> _middle; // index of shared buffer, | fresh if newly published
+        int _back; // buffer written by solver
+        int _front; // buffer read by controller
+        static const int fresh = 4; // flag in _middle
+};
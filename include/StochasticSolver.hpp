@@ -4,12 +4,24 @@
 
 #pragma once
 
-#include <memory> // std::shared_ptr
+#include <algorithm> // std::transform
+#include <array>
+#include <atomic> // std::atomic
+#include <memory> // std::shared_ptr, std::unique_ptr
 #include <random> // std::default_random_engine, std::uniform_real_distribution
 #include <vector>
 
+#include "CosineBasis.hpp"
+#include "CosineBasis2D.hpp"
 #include "D2Gauss.hpp"
 #include "D2Fourier.hpp"
+#include "D2FourierFixed.hpp"
+#include "D2Fourier2D.hpp"
+#include "D2Gauss2D.hpp"
+#include "MathUtil.hpp"
+#include "ProposalPipeline.hpp"
+#include "SolverControl.hpp"
+#include "ThreadPool.hpp"
 
 
 /**
@@ -46,7 +58,143 @@ class StochasticSolver
          */
         D2Fourier solve(std::shared_ptr<D2Fourier>, std::shared_ptr<D2Gauss>, int, int, int, double);
 
+        /**
+         * @brief Solves the equation f''(x) = g(x) as above, but evaluates
+         * the distance on a precomputed CosineBasis instead of calling
+         * the Function objects. The residual and distance of the last
+         * accepted coefficients are kept, so that every iteration needs a
+         * single distance evaluation. Throws std::invalid_argument unless
+         * the solution has basis.n() coefficients.
+         * @param g RHS of f''(x) = g(x), reference to D2Gauss object
+         * @param m number of iterations in stochastic solver, int
+         * @param basis precomputed Fourier-(cos)modes, defines n and N
+         * @param lr learning rate, double
+         * @return D2Fourier solution object with new coefficients
+         */
+        D2Fourier solve(std::shared_ptr<D2Fourier>, std::shared_ptr<D2Gauss>, int, const CosineBasis&, double);
+
+        /**
+         * @brief Solves the equation f''(x) = g(x) on a CosineBasis as above,
+         * but with g already sampled at the nodes of basis, e.g. mapped
+         * from a TableCache.
+         * @param g N samples g(x_i) of the RHS
+         * @param m number of iterations in stochastic solver, int
+         * @param basis precomputed Fourier-(cos)modes, defines n and N
+         * @param lr learning rate, double
+         * @return D2Fourier solution object with new coefficients
+         */
+        D2Fourier solve(std::shared_ptr<D2Fourier>, const double*, int, const CosineBasis&, double);
+
+        /**
+         * @brief Solves the equation f''(x) = g(x) on a CosineBasis in
+         * block-coordinate mode: the coefficients are split into consecutive
+         * blocks, and every proposal perturbs a single block only, cycling
+         * through the blocks. Candidates are scored by updating the residual
+         * with the affected basis columns only, i.e. in O(N*|block|).
+         * Every block has its own adaptive learning rate.
+         * Throws std::invalid_argument unless blocks is non-empty, every
+         * block has at least one mode, the sizes sum up to basis.n(), lr
+         * has one entry per block and the solution has basis.n() coefficients.
+         * @param g RHS of f''(x) = g(x), reference to D2Gauss object
+         * @param m number of iterations (proposals) in stochastic solver, int
+         * @param basis precomputed Fourier-(cos)modes, defines n and N
+         * @param blocks sizes of the consecutive blocks, summing up to n
+         * @param lr initial learning rate of each block
+         * @return D2Fourier solution object with new coefficients
+         */
+        D2Fourier solve(std::shared_ptr<D2Fourier>, std::shared_ptr<D2Gauss>, int, const CosineBasis&,
+                        const std::vector<int>&, std::vector<double>);
+
+        /**
+         * @brief Solves the two-dimensional Poisson equation
+         * f_xx(x,y) + f_yy(x,y) = g(x,y) on a square, where we use a
+         * tensor-product Fourier-(cos)series as ansatz function, i.e.
+         * f(x,y) = sum_k,l=0^(n-1) c_kl cos(k*x) cos(l*y). The distance
+         * is evaluated separably on a CosineBasis2D.
+         * Throws std::invalid_argument unless the solution has basis.n()
+         * modes per axis.
+         * @param g RHS, reference to D2Gauss2D object
+         * @param m number of iterations in stochastic solver, int
+         * @param basis precomputed per-axis Fourier-(cos)modes, defines n and N
+         * @param lr learning rate, double
+         * @return D2Fourier2D solution object with new coefficients
+         */
+        D2Fourier2D solve(std::shared_ptr<D2Fourier2D>, std::shared_ptr<D2Gauss2D>, int, const CosineBasis2D&, double);
+
+        /**
+         * @brief Solves the equation f''(x) = g(x) as above for a
+         * Fourier-(cos)series with compile time number of coefficients n.
+         * The distance of the last accepted coefficients is kept, so that
+         * every iteration needs a single distance evaluation.
+         * @param g RHS of f''(x) = g(x), reference to D2Gauss object
+         * @param m number of iterations in stochastic solver, int
+         * @param N number of discrete intervals for numeric integration, int
+         * @param lr learning rate, double
+         * @return D2FourierFixed<n> solution object with new coefficients
+         */
+        template <int n>
+        D2FourierFixed<n> solve(std::shared_ptr<D2FourierFixed<n>>, std::shared_ptr<D2Gauss>, int, int, double);
+
+        /**
+         * @brief Request a running solve to return early. If no solve
+         * is running, the request applies to the next one, so a cancel
+         * racing with the start of a solve is not lost. Every solve
+         * consumes the request when it returns.
+         * May be called from any thread.
+         */
+        void cancel();
+
+        /**
+         * @brief Whether the last solve returned early due to cancel(),
+         * i.e. not if the request arrived after its last iteration.
+         */
+        bool cancelled() const;
+
+        /**
+         * @brief Setter for the thread pool used to split each distance
+         * evaluation over several threads. Only used for large N,
+         * see MathUtil::Reduction. Pass nullptr to evaluate serially.
+         * @param pool shared pointer to ThreadPool
+         */
+        void set_thread_pool(std::shared_ptr<ThreadPool>);
+
+        /**
+         * @brief Setter for the mailboxes through which another thread can
+         * query and steer running solves (see SolverControl, ControlServer).
+         * Solves look at them once every control->interval() iterations.
+         * Pass nullptr to disable.
+         * @param control shared pointer to SolverControl
+         */
+        void set_control(std::shared_ptr<SolverControl>);
+
+        /**
+         * @brief Setter for the pipelined mode, in which a producer thread
+         * draws and normalizes the step vectors up to depth steps ahead of
+         * the distance evaluation (see ProposalPipeline). Results are the
+         * same as without the pipeline. Pass 0 to draw steps serially.
+         * @param depth number of steps generated ahead
+         */
+        void set_pipeline(int);
+
+        /**
+         * @brief Seconds of step generation the pipelined mode hid behind
+         * the distance evaluation in the last solve; 0 if not pipelined.
+         */
+        double overlap_gain() const;
+
     private:
+        /**
+         * @brief Publishes stats to _control, applies a requested learning
+         * rate and waits while a pause is requested.
+         * @param i current iteration
+         * @param n_accepted number of accepted proposals so far
+         * @param d distance of current coefficients
+         * @param lr learning rate, replaced by a requested one
+         * @param c current coefficients
+         * @return true -> stop was requested, solve should return
+         */
+        bool poll(long, long, double, double&, const std::vector<double>&);
+
         /**
          * @brief Computes new stochastic step vector,
          * i.e. difference to new coefficients vector.
@@ -57,7 +205,89 @@ class StochasticSolver
          */
         std::vector<double> step(int, double);
 
+        /**
+         * @brief Next step vector, taken from the pipeline if running,
+         * otherwise computed by step(n, lr).
+         * @param n number of Fourier coefficients
+         * @param lr learning rate
+         * @param dc step vector
+         */
+        void step(int, double, std::vector<double>&);
+
+        /**
+         * @brief Starts the pipeline for a solve, if enabled.
+         * @param sizes lengths of consecutive steps, repeated cyclically
+         */
+        void start_pipeline(std::vector<int>);
+
+        /**
+         * @brief Stops the pipeline of a solve and keeps its overlap gain.
+         */
+        void stop_pipeline();
+
+        /**
+         * @brief Records whether a solve was cut short by cancel() and
+         * consumes the request.
+         * @param i number of iterations done
+         * @param m number of iterations requested
+         */
+        void finish_cancel(int, int);
+
         std::default_random_engine _gen; // random engine generator for step
         std::uniform_real_distribution<double> _dist; // distribution for step
+        std::shared_ptr<ThreadPool> _pool; // optional thread pool for distance evaluation
+        std::atomic<bool> _cancel; // _cancel == true -> solve returns early
+        bool _cancelled; // last solve returned early due to cancel()
+        std::shared_ptr<SolverControl> _control; // optional mailboxes for ControlServer
+        int _pipeline_depth; // steps generated ahead, 0 -> serial steps
+        std::unique_ptr<ProposalPipeline> _pipeline; // pipeline of running solve
+        double _overlap_gain; // overlap gain of last solve
 };
 
+template <int n>
+D2FourierFixed<n> StochasticSolver::solve(
+    std::shared_ptr<D2FourierFixed<n>> d2f_s_ptr,
+    std::shared_ptr<D2Gauss> g_s_ptr,
+    int m, int N, double lr
+)
+{
+    std::array<double, n> c0 = d2f_s_ptr->get_coefficients();
+    std::array<double, n> c1 = c0;
+    std::vector<double> dc(n);
+    double d0 = MathUtil::Distance::L2(*d2f_s_ptr, *g_s_ptr, -M_PI, M_PI, N, _pool.get());
+    long n_accepted = 0;
+    start_pipeline({n});
+    int i = 0;
+    for(int i_lr = 0; i < m && !_cancel; i++)
+    {
+        if(_control && i % _control->interval() == 0 &&
+           poll(i, n_accepted, d0, lr, std::vector<double>(c0.begin(), c0.end())))
+            break;
+        step(n, lr, dc);
+        std::transform(c0.begin(), c0.end(), dc.begin(),
+                       c1.begin(), std::plus<double>()
+        );
+        d2f_s_ptr->set_coefficients(c1);
+        double d1 = MathUtil::Distance::L2(*d2f_s_ptr, *g_s_ptr, -M_PI, M_PI, N, _pool.get());
+        if(d1 < d0)
+        {
+            c0 = c1;
+            d0 = d1;
+            n_accepted++;
+            i_lr = 0;
+        }
+        else
+        {
+            i_lr++;
+            if(i_lr % 100 == 0)
+                lr *= 0.9;
+        }
+    }
+
+    finish_cancel(i, m);
+    stop_pipeline();
+    if(_control)
+        _control->publish(i, n_accepted, d0, lr, std::vector<double>(c0.begin(), c0.end()), false, _overlap_gain);
+    d2f_s_ptr->set_coefficients(c0);
+    return D2FourierFixed<n>(*d2f_s_ptr);
+}
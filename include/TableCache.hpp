@@ -0,0 +1,71 @@
+//
+//  TableCache.hpp
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory> // std::shared_ptr
+#include <string>
+
+#include "CosineBasis.hpp"
+#include "Function.hpp"
+
+
+/**
+ * @brief class TableCache keeps precomputed tables in files of a cache
+ * directory, so that large basis tables are computed with cos() only once
+ * per node instead of at every process start.
+ * Files are keyed by (n, N, interval [a, b], quadrature rule, precision),
+ * start with a versioned header holding the key and a checksum of the
+ * tables, and are memory-mapped read-only. Concurrent processes thus share
+ * one page-cache copy and nothing has to be deserialized.
+ * New files are written to a temporary name and renamed, so readers never
+ * see partial files. Any failure (missing directory, corrupt or foreign
+ * file, ...) falls back to computing the table in memory.
+ */
+class TableCache
+{
+    public:
+        /**
+         * @brief Constructor.
+         * @param directory cache directory, created if missing
+         * @param verify verify the checksum of every mapped file
+         */
+        TableCache(std::string directory, bool verify = true);
+
+        /**
+         * @brief Get CosineBasis for n modes and N intervals on [a, b],
+         * mapped from the cache file if present, otherwise computed and stored.
+         * The file holds nodes, weights and modes of the centered Riemann rule.
+         * @return shared pointer to basis, never nullptr
+         */
+        std::shared_ptr<const CosineBasis> basis(int n, int N, double a, double b);
+
+        /**
+         * @brief Get samples f(x_i) of a target at all nodes of basis,
+         * mapped from the cache file if present, otherwise computed and stored.
+         * Function objects cannot be compared, hence the caller names the
+         * target; the name must identify f including all its parameters.
+         * @param name unique name of f, e.g. "D2Gauss a=1 k=4 x0=0"
+         * @param basis basis defining the nodes
+         * @param f function to be sampled
+         * @return shared pointer to N samples, never nullptr
+         */
+        std::shared_ptr<const double> samples(const std::string& name, const CosineBasis& basis,
+                                              const Function& f);
+
+        /**
+         * @brief Version of the file format. Files of other versions are ignored.
+         */
+        static const uint32_t version = 1;
+
+    private:
+        /**
+         * @brief Path of cache file for given kind and key.
+         */
+        std::string path(const std::string& kind, int n, int N, double a, double b, uint64_t name_hash) const;
+
+        std::string _directory; // cache directory
+        bool _verify; // _verify == true -> check checksum on load
+};
@@ -0,0 +1,81 @@
+//
+//  ThreadPool.hpp
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <functional> // std::function
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief class ThreadPool keeps a fixed set of worker threads alive
+ * for the lifetime of the object, so that splitting work across threads
+ * does not pay thread creation costs on every call.
+ * Work is submitted as a loop over task indices via parallel_for.
+ * A pool may be shared: concurrent parallel_for calls run one job
+ * after the other.
+ */
+class ThreadPool
+{
+    public:
+        /**
+         * @brief Constructor.
+         * Starts num_threads - 1 workers; the calling thread of
+         * parallel_for acts as the remaining one.
+         * @param num_threads total number of threads (>= 1)
+         */
+        ThreadPool(int num_threads);
+
+        /**
+         * @brief Destructor. Stops and joins all worker threads.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Getter for total number of threads (workers + caller).
+         * @return number of threads
+         */
+        int size() const;
+
+        /**
+         * @brief Calls task(i) for all i in [0, n) distributed over
+         * all threads and blocks until every call has returned.
+         * Which thread runs which index is unspecified, hence
+         * task must not depend on it. Concurrent calls are serialized;
+         * task must not call parallel_for of the same pool.
+         * @param n number of task indices
+         * @param task callable invoked once per index
+         */
+        void parallel_for(int n, const std::function<void(int)>& task);
+
+    private:
+        /**
+         * @brief Main loop of each worker thread.
+         */
+        void work();
+
+        /**
+         * @brief Grabs and runs task indices of the current job until
+         * none are left.
+         */
+        void run_tasks();
+
+        std::vector<std::thread> _threads; // worker threads
+        std::mutex _job_mtx; // held by the caller of parallel_for for the whole job
+        std::mutex _mtx; // guards all members below
+        std::condition_variable _cv_start; // signals a new job (or shutdown)
+        std::condition_variable _cv_done; // signals completion of a job
+        const std::function<void(int)>* _task; // task of current job
+        int _n_tasks; // number of task indices of current job
+        int _next; // next task index to be grabbed
+        int _pending; // task indices not yet finished
+        unsigned long _generation; // incremented for every new job
+        bool _stop; // _stop == true -> workers shut down
+};
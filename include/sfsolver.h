@@ -0,0 +1,118 @@
+/*
+ *  sfsolver.h
+ *
+ *  C interface of the sfsolver library for embedding the stochastic
+ *  Fourier solver into other processes. Solves L f(x) = g(x) on [-pi, pi]
+ *  with g(x) the second derivative of a Gaussian a*exp(-k*(x-x0)^2),
+ *  f(x) = sum_k=0^(n-1) c_k cos(k*x) and L = d^2/dx^2 unless set by
+ *  sfs_set_operator, see StochasticSolver and LinearOperator.
+ *
+ *  All buffers are owned by the caller. A handle keeps its thread pool
+ *  and basis tables alive between calls, so repeated solves with the
+ *  same n and N do not rebuild them.
+ */
+
+#ifndef SFSOLVER_H
+#define SFSOLVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Status codes */
+#define SFS_OK 0 /* success */
+#define SFS_CANCELLED 1 /* solve returned early due to sfs_cancel */
+#define SFS_ERR_ARG -1 /* invalid argument */
+#define SFS_ERR_STATE -2 /* no problem set up yet */
+#define SFS_ERR_ALLOC -3 /* out of memory */
+
+typedef struct sfs_handle sfs_handle;
+
+/**
+ * @brief Create a solver handle.
+ * @param seed seed of the random number generator
+ * @param num_threads number of threads for distance evaluation (>= 1);
+ * only used for large N
+ * @return handle, or NULL on failure
+ */
+sfs_handle* sfs_create(unsigned int seed, int num_threads);
+
+/**
+ * @brief Destroy a handle created by sfs_create. Accepts NULL.
+ */
+void sfs_destroy(sfs_handle* h);
+
+/**
+ * @brief Keep basis tables and samples of the RHS in files of a cache
+ * directory (see TableCache), so that other processes and later runs map
+ * them instead of computing them. Takes effect with the next
+ * sfs_set_problem; a problem already set up keeps its basis until then.
+ * @param dir cache directory, created if missing; NULL disables the cache
+ * @return SFS_OK, SFS_ERR_ARG or SFS_ERR_ALLOC
+ */
+int sfs_set_cache_dir(sfs_handle* h, const char* dir);
+
+/**
+ * @brief Set up the problem and reset all coefficients to zero.
+ * The basis table is only rebuilt if n or N changed.
+ * @param a amplitude of the Gaussian
+ * @param k kernel width of the Gaussian
+ * @param x0 shift of the Gaussian
+ * @param n number of Fourier coefficients (>= 1)
+ * @param N number of discrete intervals for numeric integration (>= 1)
+ * @return SFS_OK, SFS_ERR_ARG or SFS_ERR_ALLOC
+ */
+int sfs_set_problem(sfs_handle* h, double a, double k, double x0, int n, int N);
+
+/**
+ * @brief Set the operator L = sum_j a_j d^(2j)/dx^(2j), e.g.
+ * a = {p, 1} for f'' + p*f or a = {0, 0, 1} for the fourth derivative.
+ * Keeps the current coefficients; applies to later sfs_set_problem calls too.
+ * @param a coefficients of the even derivatives
+ * @param len number of values in a (>= 1)
+ * @return SFS_OK, SFS_ERR_ARG or SFS_ERR_ALLOC
+ */
+int sfs_set_operator(sfs_handle* h, const double* a, int len);
+
+/**
+ * @brief Set the coefficients the next solve starts from (warm start).
+ * @param c coefficients (n values)
+ * @param n number of values in c, must equal n of sfs_set_problem
+ * @return SFS_OK, SFS_ERR_ARG or SFS_ERR_STATE
+ */
+int sfs_set_coefficients(sfs_handle* h, const double* c, int n);
+
+/**
+ * @brief Run the stochastic solver, starting from the current coefficients.
+ * @param m number of iterations
+ * @param lr learning rate
+ * @return SFS_OK, SFS_CANCELLED, SFS_ERR_ARG, SFS_ERR_STATE or SFS_ERR_ALLOC
+ */
+int sfs_solve(sfs_handle* h, int m, double lr);
+
+/**
+ * @brief Ask a solve currently running on h to return early. If no solve
+ * is running, the next sfs_solve returns SFS_CANCELLED right away.
+ * May be called from any thread.
+ */
+void sfs_cancel(sfs_handle* h);
+
+/**
+ * @brief Copy the current coefficients into a caller-owned buffer.
+ * @param out buffer for at least n values
+ * @param len length of out
+ * @return n on success, SFS_ERR_ARG if out is too small, or SFS_ERR_STATE
+ */
+int sfs_get_coefficients(const sfs_handle* h, double* out, int len);
+
+/**
+ * @brief L2 distance of the current coefficients, or a negative value
+ * if no problem is set up.
+ */
+double sfs_get_distance(const sfs_handle* h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SFSOLVER_H */
@@ -0,0 +1,269 @@
+//
+//  BatchSolver.cpp
+//
+
+#include <algorithm> // std::min, std::max
+#include <cmath>
+#include <stdexcept> // std::invalid_argument
+
+#include "BatchSolver.hpp"
+#include "MathUtil.hpp"
+
+
+namespace
+{
+    // Sum of squared residuals over nodes [begin, end) of the L targets
+    // b0, ..., b0 + L - 1, written to sum[0..L). The residuals of all L
+    // targets are accumulated in registers over the modes, node by node,
+    // in the same order as CosineBasis::residual, and summed up in node
+    // order as in MathUtil::Reduction (Kahan compensated, if kahan).
+    template <int L, bool kahan>
+    void accumulate_lanes(const CosineBasis& basis, const double* w, const double* g, int B, int b0,
+                          int begin, int end, double* sum)
+    {
+        int n = basis.n();
+        size_t N = basis.N();
+        const double* table = basis.column(0); // column k at offset k*N
+        double s[L] = {};
+        double c[L] = {};
+        for(int i = begin; i < end; i++)
+        {
+            double r[L] = {};
+            for(int k = 0; k < n; k++)
+            {
+                double ci = table[k * N + i];
+                const double* wk = w + (size_t)k * B + b0;
+                for(int l = 0; l < L; l++)
+                {
+                    r[l] += wk[l] * ci;
+                }
+            }
+            const double* gi = g + (size_t)i * B + b0;
+            for(int l = 0; l < L; l++)
+            {
+                r[l] -= gi[l];
+                r[l] *= r[l];
+            }
+            for(int l = 0; l < L; l++)
+            {
+                if(kahan)
+                {
+                    double y = r[l] - c[l];
+                    double t = s[l] + y;
+                    c[l] = (t - s[l]) - y;
+                    s[l] = t;
+                }
+                else
+                {
+                    s[l] += r[l];
+                }
+            }
+        }
+        for(int l = 0; l < L; l++)
+        {
+            sum[l] = s[l];
+        }
+    }
+}
+
+BatchSolver::BatchSolver() : BatchSolver(1) {}
+
+BatchSolver::BatchSolver(int seed) : _seed(seed), _cancel(false)
+{
+    _dist = std::uniform_real_distribution<double>(-1.0, 1.0);
+}
+
+std::vector<D2Fourier> BatchSolver::solve(
+    const std::vector<std::shared_ptr<D2Fourier>>& d2f,
+    const std::vector<std::shared_ptr<D2Gauss>>& g,
+    int m, const CosineBasis& basis, double lr
+)
+{
+    int B = g.size();
+    int n = basis.n();
+    int N = basis.N();
+    if(d2f.size() != g.size())
+        throw std::invalid_argument("BatchSolver::solve: d2f and g differ in size");
+    for(int b = 0; b < B; b++)
+    {
+        if(!d2f[b] || !g[b])
+            throw std::invalid_argument("BatchSolver::solve: null target");
+        if((int)d2f[b]->get_coefficients().size() != n)
+            throw std::invalid_argument("BatchSolver::solve: coefficient count differs from basis.n()");
+    }
+
+    std::vector<std::default_random_engine> gen;
+    for(int b = 0; b < B; b++)
+    {
+        gen.emplace_back(_seed + b);
+    }
+
+    // Structure-of-arrays storage, batch index runs fastest
+    std::vector<double> gs((size_t)N * B);
+    std::vector<double> c0((size_t)n * B);
+    std::vector<double> c1((size_t)n * B);
+    std::vector<double> w((size_t)n * B);
+    std::vector<double> lambda((size_t)n * B);
+    for(int b = 0; b < B; b++)
+    {
+        std::vector<double> s = basis.sample(*g[b]);
+        for(int i = 0; i < N; i++)
+        {
+            gs[(size_t)i * B + b] = s[i];
+        }
+        std::vector<double> c = d2f[b]->get_coefficients();
+        const std::vector<double>& lambda_b = d2f[b]->get_multipliers();
+        for(int k = 0; k < n; k++)
+        {
+            c0[k * B + b] = c[k];
+            lambda[k * B + b] = lambda_b[k];
+            w[k * B + b] = c[k] * lambda_b[k];
+        }
+    }
+    std::vector<double> d0(B);
+    std::vector<double> d1(B);
+    std::vector<double> lr_b(B, lr);
+    std::vector<int> i_lr(B, 0);
+    std::vector<double> dc(n);
+    distances(basis, w.data(), gs.data(), B, d0.data());
+
+    for(int i = 0; i < m && !_cancel; i++)
+    {
+        // Proposals, see StochasticSolver::step
+        for(int b = 0; b < B; b++)
+        {
+            for(int k = 0; k < n; k++)
+            {
+                dc[k] = _dist(gen[b]);
+            }
+            double norm = 0.0;
+            for(int k = 0; k < n; k++)
+            {
+                norm += dc[k] * dc[k];
+            }
+            norm = sqrt(norm);
+            for(int k = 0; k < n; k++)
+            {
+                c1[k * B + b] = c0[k * B + b] + lr_b[b] * dc[k]/norm;
+            }
+        }
+        for(int k = 0; k < n; k++)
+        {
+            for(int b = 0; b < B; b++)
+            {
+                w[k * B + b] = c1[k * B + b] * lambda[k * B + b];
+            }
+        }
+
+        distances(basis, w.data(), gs.data(), B, d1.data());
+
+        for(int b = 0; b < B; b++)
+        {
+            if(d1[b] < d0[b])
+            {
+                for(int k = 0; k < n; k++)
+                {
+                    c0[k * B + b] = c1[k * B + b];
+                }
+                d0[b] = d1[b];
+                i_lr[b] = 0;
+            }
+            else
+            {
+                i_lr[b]++;
+                if(i_lr[b] % 100 == 0)
+                    lr_b[b] *= 0.9;
+            }
+        }
+    }
+    // Consume the request, see StochasticSolver::cancel
+    _cancel = false;
+
+    std::vector<D2Fourier> res;
+    std::vector<double> c(n);
+    for(int b = 0; b < B; b++)
+    {
+        for(int k = 0; k < n; k++)
+        {
+            c[k] = c0[k * B + b];
+        }
+        d2f[b]->set_coefficients(c);
+        res.push_back(D2Fourier(*d2f[b]));
+    }
+    return res;
+}
+
+void BatchSolver::distances(const CosineBasis& basis, const double* w, const double* g, int B, double* d)
+{
+    using namespace MathUtil::Reduction;
+    int N = basis.N();
+
+    // Sums of squared residuals of all targets over nodes [begin, end)
+    // into sum, in groups of lanes targets plus single remaining ones.
+    auto accumulate = [&basis, w, g, B](int begin, int end, bool kahan, double* sum)
+    {
+        int b = 0;
+        for(; b + lanes <= B; b += lanes)
+        {
+            if(kahan)
+                accumulate_lanes<lanes, true>(basis, w, g, B, b, begin, end, sum + b);
+            else
+                accumulate_lanes<lanes, false>(basis, w, g, B, b, begin, end, sum + b);
+        }
+        for(; b < B; b++)
+        {
+            if(kahan)
+                accumulate_lanes<1, true>(basis, w, g, B, b, begin, end, sum + b);
+            else
+                accumulate_lanes<1, false>(basis, w, g, B, b, begin, end, sum + b);
+        }
+    };
+
+    // Same summation scheme as MathUtil::Reduction::sum, so that every
+    // target gets bitwise the distance of CosineBasis::l2
+    if(N < parallel_threshold)
+    {
+        accumulate(0, N, false, d);
+        for(int b = 0; b < B; b++)
+        {
+            d[b] = sqrt(d[b] * basis.dx());
+        }
+        return;
+    }
+    int n_chunks = (N + chunk_size - 1) / chunk_size;
+    _partial.resize((size_t)n_chunks * B);
+    auto chunk = [this, &accumulate, N, B](int j)
+    {
+        accumulate(j * chunk_size, std::min(N, (j + 1) * chunk_size), true, &_partial[(size_t)j * B]);
+    };
+    if(_pool)
+    {
+        _pool->parallel_for(n_chunks, chunk);
+    }
+    else
+    {
+        for(int j = 0; j < n_chunks; j++)
+        {
+            chunk(j);
+        }
+    }
+    _p.resize(n_chunks);
+    for(int b = 0; b < B; b++)
+    {
+        for(int j = 0; j < n_chunks; j++)
+        {
+            _p[j] = _partial[(size_t)j * B + b];
+        }
+        d[b] = sqrt(pairwise(_p.data(), n_chunks) * basis.dx());
+    }
+}
+
+void BatchSolver::set_thread_pool(std::shared_ptr<ThreadPool> pool)
+{
+    _pool = pool;
+}
+
+void BatchSolver::cancel()
+{
+    _cancel = true;
+}
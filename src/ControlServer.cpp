@@ -0,0 +1,159 @@
+//
+//  ControlServer.cpp
+//
+
+#include <fstream>
+#include <iostream>
+#include <limits> // std::numeric_limits
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ControlServer.hpp"
+
+
+ControlServer::ControlServer(std::string path, std::shared_ptr<SolverControl> control) :
+    _path(path), _control(control), _run(true) {}
+
+void ControlServer::operator()()
+{
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if(_path.size() >= sizeof(addr.sun_path))
+    {
+        std::cout << "Control socket path too long: " << _path << std::endl;
+        return;
+    }
+    _path.copy(addr.sun_path, _path.size());
+
+    // Replace a stale socket, but never delete anything else
+    struct stat st;
+    if(lstat(_path.c_str(), &st) == 0)
+    {
+        if(!S_ISSOCK(st.st_mode))
+        {
+            std::cout << "Opening control socket " << _path << " failed!" << std::endl;
+            return;
+        }
+        unlink(_path.c_str());
+    }
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server < 0 ||
+       bind(server, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+       listen(server, 1) != 0)
+    {
+        std::cout << "Opening control socket " << _path << " failed!" << std::endl;
+        if(server >= 0)
+            close(server);
+        return;
+    }
+
+    while(_run)
+    {
+        pollfd pfd = {server, POLLIN, 0};
+        if(poll(&pfd, 1, 100) <= 0)
+            continue;
+        int client = accept(server, nullptr, nullptr);
+        if(client < 0)
+            continue;
+
+        std::string buffer;
+        char chunk[256];
+        while(_run)
+        {
+            pollfd cfd = {client, POLLIN, 0};
+            if(poll(&cfd, 1, 100) <= 0)
+                continue;
+            ssize_t len = read(client, chunk, sizeof(chunk));
+            if(len <= 0)
+                break;
+            buffer.append(chunk, len);
+            size_t pos;
+            while((pos = buffer.find('\n')) != std::string::npos)
+            {
+                std::string reply = handle(buffer.substr(0, pos)) + "\n";
+                buffer.erase(0, pos + 1);
+                if(send(client, reply.c_str(), reply.size(), MSG_NOSIGNAL) < 0)
+                    break;
+            }
+        }
+        close(client);
+    }
+    close(server);
+    unlink(_path.c_str());
+}
+
+void ControlServer::stop()
+{
+    _run = false;
+}
+
+std::string ControlServer::handle(const std::string& line)
+{
+    std::istringstream in(line);
+    std::string cmd;
+    in >> cmd;
+    std::ostringstream out;
+    out.precision(std::numeric_limits<double>::max_digits10);
+
+    if(cmd == "stats")
+    {
+        const SolverStats& s = _control->snapshot();
+        out << "iteration " << s.iteration << " accepted " << s.accepted
+            << " distance " << s.distance << " lr " << s.lr
+            << " paused " << _control->pause_requested() << " running " << s.running << " overlap " << s.overlap;
+    }
+    else if(cmd == "coefficients")
+    {
+        const SolverStats& s = _control->snapshot();
+        for(size_t k = 0; k < s.coefficients.size(); k++)
+        {
+            out << (k > 0 ? " " : "") << s.coefficients[k];
+        }
+    }
+    else if(cmd == "pause" || cmd == "resume")
+    {
+        _control->request_pause(cmd == "pause");
+        out << "ok";
+    }
+    else if(cmd == "stop")
+    {
+        _control->request_stop();
+        out << "ok";
+    }
+    else if(cmd == "lr")
+    {
+        double lr;
+        if(!(in >> lr) || !(lr > 0.0))
+            return "error lr needs a positive value";
+        _control->request_lr(lr);
+        out << "ok";
+    }
+    else if(cmd == "checkpoint")
+    {
+        std::string path;
+        if(!(in >> path))
+            path = _path + ".checkpoint";
+        const SolverStats& s = _control->snapshot();
+        std::ofstream file(path);
+        file.precision(std::numeric_limits<double>::max_digits10);
+        file << "# iteration " << s.iteration << " distance " << s.distance << " lr " << s.lr << "\n";
+        for(size_t k = 0; k < s.coefficients.size(); k++)
+        {
+            file << (k > 0 ? " " : "") << s.coefficients[k];
+        }
+        file << "\n";
+        if(!file)
+            return "error cannot write " + path;
+        out << "ok " << path;
+    }
+    else
+    {
+        return "error unknown request '" + cmd + "'";
+    }
+    return out.str();
+}
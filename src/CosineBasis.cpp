@@ -0,0 +1,162 @@
+//
+//  CosineBasis.cpp
+//
+
+#include <algorithm> // std::copy, std::fill, std::min
+#include <cmath>
+
+#include "CosineBasis.hpp"
+#include "MathUtil.hpp"
+
+
+CosineBasis::CosineBasis(int n, int N, double a, double b) :
+    _n(n), _N(N), _a(a), _b(b), _dx((b - a) / N)
+{
+    std::shared_ptr<std::vector<double>> storage =
+        std::make_shared<std::vector<double>>((size_t)N + (size_t)n * N);
+    double* x = storage->data();
+    double* table = x + N;
+    double dx_2 = _dx / 2;
+    for(int i = 0; i < _N; i++)
+    {
+        x[i] = _a + _dx*i + dx_2;
+    }
+    for(int k = 0; k < _n; k++)
+    {
+        double* col = &table[(size_t)k * _N];
+        for(int i = 0; i < _N; i++)
+        {
+            col[i] = cos(k*x[i]);
+        }
+    }
+    _storage = storage;
+    _x = x;
+    _table = table;
+}
+
+CosineBasis::CosineBasis(int n, int N, double a, double b,
+                         std::shared_ptr<const void> storage, const double* x, const double* table) :
+    _n(n), _N(N), _a(a), _b(b), _dx((b - a) / N), _storage(storage), _x(x), _table(table) {}
+
+int CosineBasis::n() const
+{
+    return _n;
+}
+
+int CosineBasis::N() const
+{
+    return _N;
+}
+
+double CosineBasis::a() const
+{
+    return _a;
+}
+
+double CosineBasis::b() const
+{
+    return _b;
+}
+
+double CosineBasis::dx() const
+{
+    return _dx;
+}
+
+const double* CosineBasis::nodes() const
+{
+    return _x;
+}
+
+const double* CosineBasis::column(int k) const
+{
+    return _table + (size_t)k * _N;
+}
+
+std::vector<double> CosineBasis::sample(const Function& f) const
+{
+    std::vector<double> g(_N);
+    for(int i = 0; i < _N; i++)
+    {
+        g[i] = f(_x[i]);
+    }
+    return g;
+}
+
+void CosineBasis::residual(const double* w, const double* g, double* r, ThreadPool* pool) const
+{
+    // Nodes are processed in blocks, so that the block of r stays
+    // in cache while all n columns are added to it.
+    const int block = MathUtil::Reduction::chunk_size;
+    auto run = [this, w, g, r, block](int j)
+    {
+        int begin = j * block;
+        int end = std::min(_N, begin + block);
+        std::fill(r + begin, r + end, 0.0);
+        for(int k = 0; k < _n; k++)
+        {
+            double wk = w[k];
+            const double* col = column(k);
+            for(int i = begin; i < end; i++)
+            {
+                r[i] += wk * col[i];
+            }
+        }
+        for(int i = begin; i < end; i++)
+        {
+            r[i] -= g[i];
+        }
+    };
+    int n_blocks = (_N + block - 1) / block;
+    if(pool && _N >= MathUtil::Reduction::parallel_threshold)
+    {
+        pool->parallel_for(n_blocks, run);
+    }
+    else
+    {
+        for(int j = 0; j < n_blocks; j++)
+        {
+            run(j);
+        }
+    }
+}
+
+void CosineBasis::update(const double* r, int k_begin, int k_end, const double* dw, double* r_new,
+                         ThreadPool* pool) const
+{
+    const int block = MathUtil::Reduction::chunk_size;
+    auto run = [this, r, k_begin, k_end, dw, r_new, block](int j)
+    {
+        int begin = j * block;
+        int end = std::min(_N, begin + block);
+        if(r_new != r)
+            std::copy(r + begin, r + end, r_new + begin);
+        for(int k = k_begin; k < k_end; k++)
+        {
+            double dwk = dw[k - k_begin];
+            const double* col = column(k);
+            for(int i = begin; i < end; i++)
+            {
+                r_new[i] += dwk * col[i];
+            }
+        }
+    };
+    int n_blocks = (_N + block - 1) / block;
+    if(pool && _N >= MathUtil::Reduction::parallel_threshold)
+    {
+        pool->parallel_for(n_blocks, run);
+    }
+    else
+    {
+        for(int j = 0; j < n_blocks; j++)
+        {
+            run(j);
+        }
+    }
+}
+
+double CosineBasis::l2(const double* r, ThreadPool* pool) const
+{
+    double sum = MathUtil::Reduction::sum([r](int i){ return r[i] * r[i]; }, _N, pool);
+    return sqrt(sum * _dx);
+}
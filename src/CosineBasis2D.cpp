@@ -0,0 +1,119 @@
+//
+//  CosineBasis2D.cpp
+//
+
+#include <algorithm> // std::fill, std::min
+#include <cmath>
+
+#include "CosineBasis2D.hpp"
+#include "MathUtil.hpp"
+
+
+CosineBasis2D::CosineBasis2D(int n, int N, double a, double b) : _axis(n, N, a, b) {}
+
+const CosineBasis& CosineBasis2D::axis() const
+{
+    return _axis;
+}
+
+int CosineBasis2D::n() const
+{
+    return _axis.n();
+}
+
+int CosineBasis2D::N() const
+{
+    return _axis.N();
+}
+
+std::vector<double> CosineBasis2D::sample(const Function2D& f) const
+{
+    int N = _axis.N();
+    const double* x = _axis.nodes();
+    std::vector<double> g((size_t)N * N);
+    for(int i = 0; i < N; i++)
+    {
+        for(int j = 0; j < N; j++)
+        {
+            g[(size_t)i * N + j] = f(x[i], x[j]);
+        }
+    }
+    return g;
+}
+
+void CosineBasis2D::residual(const double* w, const double* g, double* r, ThreadPool* pool) const
+{
+    int n = _axis.n();
+    int N = _axis.N();
+    bool parallel = pool && (size_t)N * N >= (size_t)MathUtil::Reduction::parallel_threshold;
+
+    // T = W C, i.e. T_kj = sum_l w_kl cos(l*y_j), n x N
+    std::vector<double> t((size_t)n * N);
+    auto stage1 = [this, w, &t, n, N](int k)
+    {
+        double* tk = &t[(size_t)k * N];
+        std::fill(tk, tk + N, 0.0);
+        for(int l = 0; l < n; l++)
+        {
+            double wkl = w[k*n + l];
+            const double* col = _axis.column(l);
+            for(int j = 0; j < N; j++)
+            {
+                tk[j] += wkl * col[j];
+            }
+        }
+    };
+
+    // r = C^T T - g, i.e. r_ij = sum_k cos(k*x_i) T_kj - g_ij, in blocks of rows i
+    const int rows = 16;
+    auto stage2 = [this, g, r, &t, n, N, rows](int b)
+    {
+        int begin = b * rows;
+        int end = std::min(N, begin + rows);
+        for(int i = begin; i < end; i++)
+        {
+            double* ri = r + (size_t)i * N;
+            std::fill(ri, ri + N, 0.0);
+            for(int k = 0; k < n; k++)
+            {
+                double cki = _axis.column(k)[i];
+                const double* tk = &t[(size_t)k * N];
+                for(int j = 0; j < N; j++)
+                {
+                    ri[j] += cki * tk[j];
+                }
+            }
+            const double* gi = g + (size_t)i * N;
+            for(int j = 0; j < N; j++)
+            {
+                ri[j] -= gi[j];
+            }
+        }
+    };
+
+    int n_blocks = (N + rows - 1) / rows;
+    if(parallel)
+    {
+        pool->parallel_for(n, stage1);
+        pool->parallel_for(n_blocks, stage2);
+    }
+    else
+    {
+        for(int k = 0; k < n; k++)
+        {
+            stage1(k);
+        }
+        for(int b = 0; b < n_blocks; b++)
+        {
+            stage2(b);
+        }
+    }
+}
+
+double CosineBasis2D::l2(const double* r, ThreadPool* pool) const
+{
+    int N = _axis.N();
+    double dx = _axis.dx();
+    double sum = MathUtil::Reduction::sum([r](int i){ return r[i] * r[i]; }, N * N, pool);
+    return sqrt(sum * dx * dx);
+}
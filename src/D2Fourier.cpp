@@ -9,7 +9,10 @@
 
 D2Fourier::D2Fourier() : _c({}), _n(0) {}
 
-D2Fourier::D2Fourier(std::vector<double> c) : _c(c), _n(_c.size()) {}
+D2Fourier::D2Fourier(std::vector<double> c) : _c(c), _n(_c.size()), _m(_op.multipliers(_n)) {}
+
+D2Fourier::D2Fourier(std::vector<double> c, LinearOperator op) :
+    _c(c), _n(_c.size()), _op(op), _m(_op.multipliers(_n)) {}
 
 std::vector<double> D2Fourier::get_coefficients()
 {
@@ -19,7 +22,21 @@ std::vector<double> D2Fourier::get_coefficients()
 void D2Fourier::set_coefficients(const std::vector<double> c)
 {
     _c = c;
-    _n = _c.size();
+    if((int)_c.size() != _n)
+    {
+        _n = _c.size();
+        _m = _op.multipliers(_n);
+    }
+}
+
+LinearOperator D2Fourier::get_operator() const
+{
+    return _op;
+}
+
+const std::vector<double>& D2Fourier::get_multipliers() const
+{
+    return _m;
 }
 
 double D2Fourier::operator()(double x) const
@@ -27,7 +44,7 @@ double D2Fourier::operator()(double x) const
     double sum = 0.0;
     for(int k = 0; k < _n; k++)
     {
-        sum += _c[k] * (-k*k) * cos(k*x);
+        sum += _c[k] * _m[k] * cos(k*x);
     }
     return sum;
 }
@@ -42,7 +59,7 @@ std::string D2Fourier::gnuplot_plot() const
     std::string s = "";
     for(int k = 0; k < _n; k++)
     {
-        s += std::to_string(_c[k]) + " * (" + std::to_string(k) + ")**2 * (-1) * cos(" + std::to_string(k) + " * x)";
+        s += std::to_string(_c[k]) + " * (" + std::to_string(_m[k]) + ") * cos(" + std::to_string(k) + " * x)";
         s += k < (_n - 1) ? " + " : "";
     }
     return s;
@@ -50,6 +67,6 @@ std::string D2Fourier::gnuplot_plot() const
 
 std::string D2Fourier::gnuplot_title() const
 {
-    std::string s = "d^2/dx^2 f(x) = d^2/dx^2 {/Symbol S}@^{n-1}_{k=0} c_k cos(kx)";
+    std::string s = _op.gnuplot_title() + " with f(x) = {/Symbol S}@^{n-1}_{k=0} c_k cos(kx)";
     return s;
 }
@@ -0,0 +1,119 @@
+//
+//  D2Fourier2D.cpp
+//
+
+#include <cmath>
+#include <stdexcept> // std::invalid_argument
+
+#include "D2Fourier2D.hpp"
+
+
+namespace
+{
+    // Number of modes per axis for size coefficients, which must be a square
+    int side(size_t size)
+    {
+        int n = std::lround(std::sqrt(size));
+        if((size_t)(n*n) != size)
+            throw std::invalid_argument("D2Fourier2D: number of coefficients must be a square n*n");
+        return n;
+    }
+}
+
+D2Fourier2D::D2Fourier2D() : _c({}), _n(0) {}
+
+D2Fourier2D::D2Fourier2D(std::vector<double> c) : _c(c), _n(0)
+{
+    resize();
+}
+
+D2Fourier2D::D2Fourier2D(std::vector<double> c, LinearOperator op) : _c(c), _n(0), _op(op)
+{
+    resize();
+}
+
+std::vector<double> D2Fourier2D::get_coefficients() const
+{
+    return _c;
+}
+
+void D2Fourier2D::set_coefficients(const std::vector<double> c)
+{
+    side(c.size());
+    _c = c;
+    if((int)_c.size() != _n*_n)
+        resize();
+}
+
+int D2Fourier2D::get_n() const
+{
+    return _n;
+}
+
+const std::vector<double>& D2Fourier2D::get_multipliers() const
+{
+    return _m;
+}
+
+void D2Fourier2D::resize()
+{
+    _n = side(_c.size());
+    _m.resize(_n*_n);
+    for(int k = 0; k < _n; k++)
+    {
+        for(int l = 0; l < _n; l++)
+        {
+            _m[k*_n + l] = _op.multiplier(k, l);
+        }
+    }
+}
+
+double D2Fourier2D::operator()(double x, double y) const
+{
+    // Cosines along y, on the stack unless n is unusually large
+    const int n_stack = 64;
+    double cy_stack[n_stack];
+    std::vector<double> cy_heap(_n > n_stack ? _n : 0);
+    double* cy = _n > n_stack ? cy_heap.data() : cy_stack;
+    for(int l = 0; l < _n; l++)
+    {
+        cy[l] = cos(l*y);
+    }
+    double sum = 0.0;
+    for(int k = 0; k < _n; k++)
+    {
+        double row = 0.0;
+        for(int l = 0; l < _n; l++)
+        {
+            row += _c[k*_n + l] * _m[k*_n + l] * cy[l];
+        }
+        sum += row * cos(k*x);
+    }
+    return sum;
+}
+
+Function2D * D2Fourier2D::clone() const
+{
+    return new D2Fourier2D(*this);
+}
+
+std::string D2Fourier2D::gnuplot_plot() const
+{
+    std::string s = "";
+    for(int k = 0; k < _n; k++)
+    {
+        for(int l = 0; l < _n; l++)
+        {
+            s += std::to_string(_c[k*_n + l]) + " * (" + std::to_string(_m[k*_n + l]) + ") * cos(" +
+                 std::to_string(k) + " * x) * cos(" + std::to_string(l) + " * y)";
+            s += k*_n + l < (_n*_n - 1) ? " + " : "";
+        }
+    }
+    return s;
+}
+
+std::string D2Fourier2D::gnuplot_title() const
+{
+    std::string s = _op.gnuplot_title_2d() + " with f(x,y) = {/Symbol S}@^{n-1}_{k,l=0} c_{kl} cos(kx) cos(ly)";
+    return s;
+}
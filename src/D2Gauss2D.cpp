@@ -0,0 +1,37 @@
+//
+//  D2Gauss2D.cpp
+//
+
+#include <cmath>
+
+#include "D2Gauss2D.hpp"
+
+
+D2Gauss2D::D2Gauss2D() : _a(1.0), _k(1.0), _x0(0.0), _y0(0.0) {}
+
+D2Gauss2D::D2Gauss2D(double a, double k, double x0, double y0) : _a(a), _k(k), _x0(x0), _y0(y0) {}
+
+double D2Gauss2D::operator()(double x, double y) const
+{
+    double r2 = (x-_x0)*(x-_x0) + (y-_y0)*(y-_y0);
+    return _a * exp(-_k*r2) * (-4*_k + 4*_k*_k*r2);
+}
+
+Function2D * D2Gauss2D::clone() const
+{
+    return new D2Gauss2D(*this);
+}
+
+std::string D2Gauss2D::gnuplot_plot() const
+{
+    std::string r2 = "((x-" + std::to_string(_x0) + ")**2 + (y-" + std::to_string(_y0) + ")**2)";
+    std::string s = std::to_string(_a) + "*exp(-" + std::to_string(_k) + "*" + r2 + ")*" +
+                    "(-4*" + std::to_string(_k) + " + 4*" + std::to_string(_k) + "**2*" + r2 + ")";
+    return s;
+}
+
+std::string D2Gauss2D::gnuplot_title() const
+{
+    std::string s = "g(x,y) = {/Symbol D} a exp(-k(x^2+y^2))";
+    return s;
+}
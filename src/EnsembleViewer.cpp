@@ -0,0 +1,146 @@
+//
+//  EnsembleViewer.cpp
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#include "D2Fourier.hpp"
+#include "EnsembleViewer.hpp"
+
+
+EnsembleViewer::EnsembleViewer(double max_fps) : _frame_ms(1000.0 / max_fps), _run(true) {}
+
+void EnsembleViewer::add(std::string label, std::shared_ptr<SolverControl> control,
+                         std::shared_ptr<Function> g, LinearOperator op)
+{
+    std::lock_guard<std::mutex> lock(_mtx);
+    _runs.push_back({label, control, g, op, -1, {}, {}, {}});
+}
+
+void EnsembleViewer::operator()()
+{
+    FILE* pipe;
+    std::cout << "Opening gnuplot... ";
+    pipe = popen("gnuplot -persist", "w");
+    if (!pipe)
+    {
+        std::cout << "failed!" << std::endl;
+        return;
+    }
+    std::cout << "succeded." << std::endl;
+
+    std::string setup = "set samples 500\n"
+                        "set key top right font ',8'\n"
+                        "set xlabel 'x'\n";
+    fwrite(setup.c_str(), 1, setup.size(), pipe);
+    fflush(pipe);
+
+    auto last = std::chrono::steady_clock::now() - std::chrono::hours(1);
+    while(_run)
+    {
+        auto now = std::chrono::steady_clock::now();
+        double wait_ms = _frame_ms - std::chrono::duration<double, std::milli>(now - last).count();
+        if(wait_ms > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(std::min(wait_ms, 50.0)));
+            continue;
+        }
+        std::string cmd;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if(update())
+                cmd = frame();
+        }
+        if(!cmd.empty())
+        {
+            fwrite(cmd.c_str(), 1, cmd.size(), pipe);
+            fflush(pipe);
+        }
+        last = now;
+    }
+    pclose(pipe);
+}
+
+void EnsembleViewer::stop()
+{
+    _run = false;
+}
+
+bool EnsembleViewer::update()
+{
+    bool changed = false;
+    for(Run& run : _runs)
+    {
+        const SolverStats& s = run.control->snapshot();
+        if(s.iteration == run.iteration || s.coefficients.empty())
+            continue;
+        run.iteration = s.iteration;
+        run.coefficients = s.coefficients;
+        run.hist_iteration.push_back(s.iteration);
+        run.hist_distance.push_back(s.distance);
+        if(run.hist_iteration.size() > max_points)
+        {
+            // Thin out the curve by keeping every second point
+            size_t j = 0;
+            for(size_t i = 0; i < run.hist_iteration.size(); i += 2, j++)
+            {
+                run.hist_iteration[j] = run.hist_iteration[i];
+                run.hist_distance[j] = run.hist_distance[i];
+            }
+            run.hist_iteration.resize(j);
+            run.hist_distance.resize(j);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+std::string EnsembleViewer::frame() const
+{
+    int n_panels = _runs.size() + 1;
+    int cols = std::ceil(std::sqrt(n_panels));
+    int rows = (n_panels + cols - 1) / cols;
+    std::string cmd;
+
+    // Convergence curves as inline data blocks
+    for(size_t r = 0; r < _runs.size(); r++)
+    {
+        cmd += "$conv" + std::to_string(r) + " << EOD\n";
+        for(size_t i = 0; i < _runs[r].hist_iteration.size(); i++)
+        {
+            cmd += std::to_string(_runs[r].hist_iteration[i]) + " " + std::to_string(_runs[r].hist_distance[i]) + "\n";
+        }
+        cmd += "EOD\n";
+    }
+
+    cmd += "set multiplot layout " + std::to_string(rows) + "," + std::to_string(cols) +
+           " title 'Stochastic Fourier Solver ensemble (" + std::to_string(_runs.size()) + " runs)'\n";
+    cmd += "unset logscale y\nset xlabel 'x'\nset ylabel ''\nset yrange [-10:10]\n";
+    for(const Run& run : _runs)
+    {
+        cmd += "set title '" + run.label + "'\n";
+        cmd += "plot [-pi:pi] ";
+        if(!run.coefficients.empty())
+        {
+            D2Fourier d2f(run.coefficients, run.op);
+            cmd += d2f.gnuplot_plot() + " with lines title 'solution', ";
+        }
+        cmd += run.g->gnuplot_plot() + " with lines title 'RHS'\n";
+    }
+    cmd += "set title 'convergence'\nset xlabel 'iteration'\nset ylabel 'distance'\n"
+           "set autoscale y\nset logscale y\n";
+    cmd += "plot ";
+    for(size_t r = 0; r < _runs.size(); r++)
+    {
+        cmd += "$conv" + std::to_string(r) + " with lines title '" + _runs[r].label + "'";
+        cmd += r + 1 < _runs.size() ? ", " : "\n";
+    }
+    if(_runs.empty())
+        cmd += "NaN notitle\n";
+    cmd += "unset multiplot\n";
+    return cmd;
+}
@@ -20,6 +20,15 @@ GnuplotFunctionViewer::GnuplotFunctionViewer(std::vector<std::shared_ptr<Functio
     _vec_s_ptr = vec_s_ptr;
     _n = vec_s_ptr.size();
     _run = false;
+    _heatmap = false;
+}
+
+GnuplotFunctionViewer::GnuplotFunctionViewer(std::vector<std::shared_ptr<Function2D>> vec_s_ptr)
+{
+    _vec2d_s_ptr = vec_s_ptr;
+    _n = vec_s_ptr.size();
+    _run = false;
+    _heatmap = true;
 }
 
 void GnuplotFunctionViewer::operator()()
@@ -44,12 +53,36 @@ void GnuplotFunctionViewer::operator()()
     fflush(pipe);
     fputs("set xlabel 'x'\n", pipe);
     fflush(pipe);
-    fputs("set ylabel 'functions'\n", pipe);
-    fflush(pipe);
-    fputs("set yrange [-10:10]\n", pipe);
-    fflush(pipe);
+    if(_heatmap)
+    {
+        fputs("set ylabel 'y'\n", pipe);
+        fputs("set view map\n", pipe);
+        fputs("set isosamples 100\n", pipe);
+        fputs("set palette rgbformulae 33,13,10\n", pipe);
+        fflush(pipe);
+    }
+    else
+    {
+        fputs("set ylabel 'functions'\n", pipe);
+        fflush(pipe);
+        fputs("set yrange [-10:10]\n", pipe);
+        fflush(pipe);
+    }
     std::string cmd;
-    while(_run)
+    while(_run && _heatmap)
+    {
+        cmd = "set multiplot layout 1," + std::to_string(_n) + "\n";
+        for(int j = 0; j < _n; j++)
+        {
+            std::shared_ptr<Function2D> f = _vec2d_s_ptr[j];
+            cmd += "splot [-pi:pi] [-pi:pi] " + f->gnuplot_plot() + " with pm3d title '" + f->gnuplot_title() + "'\n";
+        }
+        cmd += "unset multiplot\n";
+        fputs(cmd.c_str(), pipe);
+        fflush(pipe);
+        mysleep(20);
+    }
+    while(_run && !_heatmap)
     {
         fputs("plot [-pi:pi] ", pipe);
         for(int j = 0; j < _n; j++)
@@ -0,0 +1,104 @@
+//
+//  LinearOperator.cpp
+//
+
+#include <cmath> // std::abs
+#include <sstream>
+
+#include "LinearOperator.hpp"
+
+
+LinearOperator::LinearOperator() : _a({0.0, 1.0}) {}
+
+LinearOperator::LinearOperator(std::vector<double> a) : _a(a) {}
+
+LinearOperator LinearOperator::second_derivative()
+{
+    return LinearOperator({0.0, 1.0});
+}
+
+LinearOperator LinearOperator::helmholtz(double p)
+{
+    return LinearOperator({p, 1.0});
+}
+
+LinearOperator LinearOperator::screened_poisson(double kappa)
+{
+    return LinearOperator({-kappa*kappa, 1.0});
+}
+
+LinearOperator LinearOperator::fourth_derivative()
+{
+    return LinearOperator({0.0, 0.0, 1.0});
+}
+
+std::vector<double> LinearOperator::get_coefficients() const
+{
+    return _a;
+}
+
+double LinearOperator::multiplier(int k) const
+{
+    return multiplier(k, 0);
+}
+
+double LinearOperator::multiplier(int k, int l) const
+{
+    // Horner scheme in (-k*k - l*l); exact -k*k - l*l for the second derivative
+    double lambda = 0.0;
+    double s = -k*k - l*l;
+    for(int j = _a.size() - 1; j >= 0; j--)
+    {
+        lambda = lambda * s + _a[j];
+    }
+    return lambda;
+}
+
+std::vector<double> LinearOperator::multipliers(int n) const
+{
+    std::vector<double> lambda(n);
+    for(int k = 0; k < n; k++)
+    {
+        lambda[k] = multiplier(k);
+    }
+    return lambda;
+}
+
+std::string LinearOperator::gnuplot_title() const
+{
+    return title(false);
+}
+
+std::string LinearOperator::gnuplot_title_2d() const
+{
+    return title(true);
+}
+
+std::string LinearOperator::title(bool two_d) const
+{
+    std::string f = two_d ? "f(x,y)" : "f(x)";
+    std::ostringstream s;
+    bool first = true;
+    for(int j = _a.size() - 1; j >= 0; j--)
+    {
+        if(_a[j] == 0.0)
+            continue;
+        double a = _a[j];
+        if(!first)
+        {
+            s << (a < 0.0 ? " - " : " + ");
+            a = std::abs(a);
+        }
+        if(a != 1.0)
+            s << a << " ";
+        if(j > 0 && two_d)
+            s << "{/Symbol D}" << (j > 1 ? "^" + std::to_string(j) : "") << " ";
+        else if(j > 0)
+            s << "d^" << 2*j << "/dx^" << 2*j << " ";
+        s << f;
+        first = false;
+    }
+    if(first)
+        s << "0";
+    return s.str();
+}
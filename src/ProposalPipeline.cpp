@@ -0,0 +1,106 @@
+//
+//  ProposalPipeline.cpp
+//
+
+#include <algorithm> // std::max, std::transform
+#include <chrono>
+#include <cmath> // sqrt
+#include <numeric> // std::inner_product
+
+#include "ProposalPipeline.hpp"
+
+
+ProposalPipeline::ProposalPipeline(std::default_random_engine& gen,
+                                   const std::uniform_real_distribution<double>& dist,
+                                   std::vector<int> sizes, int depth) :
+    _gen(gen), _gen_producer(gen), _dist(dist), _sizes(sizes),
+    _slots(depth > 0 ? depth : 1), _head(0), _tail(0), _run(true),
+    _produced(0.0), _stalled(0.0)
+{
+    int max_size = *std::max_element(_sizes.begin(), _sizes.end());
+    for(Slot& slot : _slots)
+    {
+        slot.d.reserve(max_size);
+    }
+    _producer = std::thread(&ProposalPipeline::produce, this);
+}
+
+ProposalPipeline::~ProposalPipeline()
+{
+    stop();
+}
+
+void ProposalPipeline::produce()
+{
+    auto start = std::chrono::steady_clock::now();
+    for(size_t j = 0; _run; j++)
+    {
+        // Wait for a free slot; back off to sleeping if the consumer
+        // does not come along, e.g. because the solve is paused.
+        for(int spin = 0; j - _head.load(std::memory_order_acquire) >= _slots.size(); spin++)
+        {
+            if(!_run)
+                return;
+            if(spin < 100)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            start = std::chrono::steady_clock::now();
+        }
+
+        Slot& slot = _slots[j % _slots.size()];
+        slot.d.resize(_sizes[j % _sizes.size()]);
+        for(double& d : slot.d)
+        {
+            d = _dist(_gen_producer);
+        }
+        slot.norm = sqrt(
+            std::inner_product(
+                slot.d.begin(), slot.d.end(),
+                slot.d.begin(), 0.0
+            )
+        );
+        slot.gen = _gen_producer;
+        auto end = std::chrono::steady_clock::now();
+        slot.seconds = std::chrono::duration<double>(end - start).count();
+        start = end;
+        _tail.store(j + 1, std::memory_order_release);
+    }
+}
+
+void ProposalPipeline::pop(double lr, std::vector<double>& dc)
+{
+    size_t head = _head.load(std::memory_order_relaxed);
+    if(head == _tail.load(std::memory_order_acquire))
+    {
+        auto start = std::chrono::steady_clock::now();
+        while(head == _tail.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+        _stalled += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const Slot& slot = _slots[head % _slots.size()];
+    double norm = slot.norm;
+    dc.resize(slot.d.size());
+    std::transform(
+        slot.d.begin(), slot.d.end(),
+        dc.begin(), [lr, norm](double d){ return lr * d/norm; }
+    );
+    _produced += slot.seconds;
+    _gen = slot.gen;
+    _head.store(head + 1, std::memory_order_release);
+}
+
+void ProposalPipeline::stop()
+{
+    _run = false;
+    if(_producer.joinable())
+        _producer.join();
+}
+
+double ProposalPipeline::overlap_gain() const
+{
+    return std::max(_produced - _stalled, 0.0);
+}
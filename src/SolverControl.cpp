@@ -0,0 +1,70 @@
+//
+//  SolverControl.cpp
+//
+
+#include <cmath> // NAN, std::isnan
+
+#include "SolverControl.hpp"
+
+
+SolverControl::SolverControl(int interval) :
+    _interval(interval > 0 ? interval : 1), _stop(false), _pause(false), _lr(NAN),
+    _middle(1), _back(0), _front(2) {}
+
+int SolverControl::interval() const
+{
+    return _interval;
+}
+
+void SolverControl::publish(long iteration, long accepted, double distance, double lr,
+                            const std::vector<double>& c, bool running, double overlap)
+{
+    SolverStats& s = _buffers[_back];
+    s.iteration = iteration;
+    s.accepted = accepted;
+    s.distance = distance;
+    s.lr = lr;
+    s.running = running;
+    s.overlap = overlap;
+    s.coefficients.assign(c.begin(), c.end());
+    _back = _middle.exchange(_back | fresh) & ~fresh;
+}
+
+bool SolverControl::stop_requested() const
+{
+    return _stop;
+}
+
+bool SolverControl::pause_requested() const
+{
+    return _pause;
+}
+
+double SolverControl::take_lr()
+{
+    if(std::isnan(_lr.load()))
+        return NAN;
+    return _lr.exchange(NAN);
+}
+
+const SolverStats& SolverControl::snapshot()
+{
+    if(_middle.load() & fresh)
+        _front = _middle.exchange(_front) & ~fresh;
+    return _buffers[_front];
+}
+
+void SolverControl::request_stop()
+{
+    _stop = true;
+}
+
+void SolverControl::request_pause(bool pause)
+{
+    _pause = pause;
+}
+
+void SolverControl::request_lr(double lr)
+{
+    _lr = lr;
+}
@@ -2,25 +2,40 @@
 //  StochasticSolver.cpp
 //
 
-#include <algorithm> // std::transform
+#include <algorithm> // std::fill, std::transform
+#include <chrono> // std::chrono::milliseconds
+#include <cmath> // std::isnan
 #include <numeric> // std::inner_product
+#include <stdexcept> // std::invalid_argument
+#include <thread> // std::this_thread::sleep_for
 
 #include "MathUtil.hpp"
 #include "StochasticSolver.hpp"
 
 
-StochasticSolver::StochasticSolver()
+namespace
+{
+    // Throws unless d2f has n coefficients and multipliers, as the basis
+    // solves index both up to basis.n()
+    void check_modes(D2Fourier& d2f, int n)
+    {
+        if((int)d2f.get_coefficients().size() != n || (int)d2f.get_multipliers().size() != n)
+            throw std::invalid_argument("StochasticSolver::solve: coefficient count differs from basis.n()");
+    }
+}
+
+StochasticSolver::StochasticSolver() : _cancel(false), _cancelled(false), _pipeline_depth(0), _overlap_gain(0.0)
 {
     _gen = std::default_random_engine(1);
     _dist = std::uniform_real_distribution<double>(-1.0, 1.0);
 }
 
-StochasticSolver::StochasticSolver(int seed)
+StochasticSolver::StochasticSolver(int seed) : _cancel(false), _cancelled(false), _pipeline_depth(0), _overlap_gain(0.0)
 {
     _gen = std::default_random_engine(seed);
     _dist = std::uniform_real_distribution<double>(-1.0, 1.0);
 }
-#include <iostream>
+
 D2Fourier StochasticSolver::solve(
     std::shared_ptr<D2Fourier> d2f_s_ptr,
     std::shared_ptr<D2Gauss> g_s_ptr,
@@ -29,20 +44,27 @@ D2Fourier StochasticSolver::solve(
 {
     std::vector<double> c0 = d2f_s_ptr->get_coefficients();
     std::vector<double> c1 = c0;
-    D2Fourier d2f_prev(c1);
     std::vector<double> dc(n);
-    for(int i = 0, i_lr = 0; i < m; i++)
+    // Distance of the last accepted coefficients
+    double d0 = MathUtil::Distance::L2(*d2f_s_ptr, *g_s_ptr, -M_PI, M_PI, N, _pool.get());
+    long n_accepted = 0;
+    start_pipeline({n});
+    int i = 0;
+    for(int i_lr = 0; i < m && !_cancel; i++)
     {
-        dc = step(n, lr);
+        if(_control && i % _control->interval() == 0 && poll(i, n_accepted, d0, lr, c0))
+            break;
+        step(n, lr, dc);
         std::transform(c0.begin(), c0.end(), dc.begin(),
                        c1.begin(), std::plus<double>()
         );
         d2f_s_ptr->set_coefficients(c1);
-        if(MathUtil::Distance::L2(*d2f_s_ptr, *g_s_ptr, -M_PI, M_PI, N) <
-            MathUtil::Distance::L2(d2f_prev, *g_s_ptr, -M_PI, M_PI, N))
+        double d1 = MathUtil::Distance::L2(*d2f_s_ptr, *g_s_ptr, -M_PI, M_PI, N, _pool.get());
+        if(d1 < d0)
         {
             c0 = d2f_s_ptr->get_coefficients();
-            d2f_prev.set_coefficients(c0);
+            d0 = d1;
+            n_accepted++;
             i_lr = 0;
         }
         else
@@ -52,10 +74,332 @@ D2Fourier StochasticSolver::solve(
                 lr *= 0.9;
         }
     }
+    finish_cancel(i, m);
+    stop_pipeline();
+    if(_control)
+        _control->publish(i, n_accepted, d0, lr, c0, false, _overlap_gain);
+    d2f_s_ptr->set_coefficients(c0);
+    return D2Fourier(*d2f_s_ptr);
+}
 
+D2Fourier StochasticSolver::solve(
+    std::shared_ptr<D2Fourier> d2f_s_ptr,
+    std::shared_ptr<D2Gauss> g_s_ptr,
+    int m, const CosineBasis& basis, double lr
+)
+{
+    std::vector<double> g = basis.sample(*g_s_ptr);
+    return solve(d2f_s_ptr, g.data(), m, basis, lr);
+}
+
+D2Fourier StochasticSolver::solve(
+    std::shared_ptr<D2Fourier> d2f_s_ptr,
+    const double* g,
+    int m, const CosineBasis& basis, double lr
+)
+{
+    int n = basis.n();
+    int N = basis.N();
+    check_modes(*d2f_s_ptr, n);
+    std::vector<double> c0 = d2f_s_ptr->get_coefficients();
+    std::vector<double> c1 = c0;
+    std::vector<double> w(n);
+    std::vector<double> r0(N);
+    std::vector<double> r1(N);
+    std::vector<double> dc(n);
+    const std::vector<double>& lambda = d2f_s_ptr->get_multipliers();
+
+    for(int k = 0; k < n; k++)
+    {
+        w[k] = c0[k] * lambda[k];
+    }
+    basis.residual(w.data(), g, r0.data(), _pool.get());
+    double d0 = basis.l2(r0.data(), _pool.get());
+
+    long n_accepted = 0;
+    start_pipeline({n});
+    int i = 0;
+    for(int i_lr = 0; i < m && !_cancel; i++)
+    {
+        if(_control && i % _control->interval() == 0 && poll(i, n_accepted, d0, lr, c0))
+            break;
+        step(n, lr, dc);
+        std::transform(c0.begin(), c0.end(), dc.begin(),
+                       c1.begin(), std::plus<double>()
+        );
+        for(int k = 0; k < n; k++)
+        {
+            w[k] = c1[k] * lambda[k];
+        }
+        basis.residual(w.data(), g, r1.data(), _pool.get());
+        double d1 = basis.l2(r1.data(), _pool.get());
+        if(d1 < d0)
+        {
+            c0.swap(c1);
+            r0.swap(r1);
+            d0 = d1;
+            d2f_s_ptr->set_coefficients(c0);
+            n_accepted++;
+            i_lr = 0;
+        }
+        else
+        {
+            i_lr++;
+            if(i_lr % 100 == 0)
+                lr *= 0.9;
+        }
+    }
+
+    finish_cancel(i, m);
+    stop_pipeline();
+    if(_control)
+        _control->publish(i, n_accepted, d0, lr, c0, false, _overlap_gain);
+    d2f_s_ptr->set_coefficients(c0);
     return D2Fourier(*d2f_s_ptr);
 }
 
+D2Fourier StochasticSolver::solve(
+    std::shared_ptr<D2Fourier> d2f_s_ptr,
+    std::shared_ptr<D2Gauss> g_s_ptr,
+    int m, const CosineBasis& basis,
+    const std::vector<int>& blocks, std::vector<double> lr
+)
+{
+    int n = basis.n();
+    int N = basis.N();
+    int n_blocks = blocks.size();
+    if(n_blocks == 0)
+        throw std::invalid_argument("StochasticSolver::solve: need at least one block");
+    if((int)lr.size() != n_blocks)
+        throw std::invalid_argument("StochasticSolver::solve: need one learning rate per block");
+    std::vector<int> begin(n_blocks + 1, 0);
+    for(int b = 0; b < n_blocks; b++)
+    {
+        if(blocks[b] < 1)
+            throw std::invalid_argument("StochasticSolver::solve: empty block");
+        begin[b + 1] = begin[b] + blocks[b];
+    }
+    if(begin[n_blocks] != n)
+        throw std::invalid_argument("StochasticSolver::solve: block sizes must sum up to basis.n()");
+    check_modes(*d2f_s_ptr, n);
+    std::vector<int> i_lr(n_blocks, 0);
+
+    std::vector<double> g = basis.sample(*g_s_ptr);
+    std::vector<double> c = d2f_s_ptr->get_coefficients();
+    std::vector<double> w(n);
+    std::vector<double> r0(N);
+    std::vector<double> r1(N);
+    std::vector<double> dc;
+    std::vector<double> dw;
+    const std::vector<double>& lambda = d2f_s_ptr->get_multipliers();
+
+    for(int k = 0; k < n; k++)
+    {
+        w[k] = c[k] * lambda[k];
+    }
+    basis.residual(w.data(), g.data(), r0.data(), _pool.get());
+    double d0 = basis.l2(r0.data(), _pool.get());
+
+    long n_accepted = 0;
+    start_pipeline(blocks);
+    int i = 0;
+    for(; i < m && !_cancel; i++)
+    {
+        if(_control && i % _control->interval() == 0)
+        {
+            // A requested learning rate applies to all blocks
+            double lr_all = lr[0];
+            if(poll(i, n_accepted, d0, lr_all, c))
+                break;
+            if(lr_all != lr[0])
+                std::fill(lr.begin(), lr.end(), lr_all);
+        }
+        int b = i % n_blocks;
+        int k0 = begin[b];
+        int k1 = begin[b + 1];
+        step(k1 - k0, lr[b], dc);
+        dw.resize(k1 - k0);
+        for(int k = k0; k < k1; k++)
+        {
+            dw[k - k0] = dc[k - k0] * lambda[k];
+        }
+        basis.update(r0.data(), k0, k1, dw.data(), r1.data(), _pool.get());
+        double d1 = basis.l2(r1.data(), _pool.get());
+        if(d1 < d0)
+        {
+            for(int k = k0; k < k1; k++)
+            {
+                c[k] += dc[k - k0];
+            }
+            r0.swap(r1);
+            d0 = d1;
+            i_lr[b] = 0;
+            // Recompute the residual from scratch from time to time,
+            // so that rounding errors of the updates do not pile up.
+            if(++n_accepted % 1000 == 0)
+            {
+                for(int k = 0; k < n; k++)
+                {
+                    w[k] = c[k] * lambda[k];
+                }
+                basis.residual(w.data(), g.data(), r0.data(), _pool.get());
+                d0 = basis.l2(r0.data(), _pool.get());
+            }
+            d2f_s_ptr->set_coefficients(c);
+        }
+        else
+        {
+            i_lr[b]++;
+            if(i_lr[b] % 100 == 0)
+                lr[b] *= 0.9;
+        }
+    }
+
+    finish_cancel(i, m);
+    stop_pipeline();
+    if(_control)
+        _control->publish(i, n_accepted, d0, lr[0], c, false, _overlap_gain);
+    d2f_s_ptr->set_coefficients(c);
+    return D2Fourier(*d2f_s_ptr);
+}
+
+D2Fourier2D StochasticSolver::solve(
+    std::shared_ptr<D2Fourier2D> d2f_s_ptr,
+    std::shared_ptr<D2Gauss2D> g_s_ptr,
+    int m, const CosineBasis2D& basis, double lr
+)
+{
+    if(d2f_s_ptr->get_n() != basis.n())
+        throw std::invalid_argument("StochasticSolver::solve: mode count differs from basis.n()");
+    int n = basis.n() * basis.n();
+    size_t N = (size_t)basis.N() * basis.N();
+    std::vector<double> g = basis.sample(*g_s_ptr);
+    std::vector<double> c0 = d2f_s_ptr->get_coefficients();
+    std::vector<double> c1 = c0;
+    std::vector<double> w(n);
+    std::vector<double> r(N);
+    std::vector<double> dc(n);
+    const std::vector<double>& lambda = d2f_s_ptr->get_multipliers();
+
+    for(int k = 0; k < n; k++)
+    {
+        w[k] = c0[k] * lambda[k];
+    }
+    basis.residual(w.data(), g.data(), r.data(), _pool.get());
+    double d0 = basis.l2(r.data(), _pool.get());
+
+    long n_accepted = 0;
+    start_pipeline({n});
+    int i = 0;
+    for(int i_lr = 0; i < m && !_cancel; i++)
+    {
+        if(_control && i % _control->interval() == 0 && poll(i, n_accepted, d0, lr, c0))
+            break;
+        step(n, lr, dc);
+        std::transform(c0.begin(), c0.end(), dc.begin(),
+                       c1.begin(), std::plus<double>()
+        );
+        for(int k = 0; k < n; k++)
+        {
+            w[k] = c1[k] * lambda[k];
+        }
+        basis.residual(w.data(), g.data(), r.data(), _pool.get());
+        double d1 = basis.l2(r.data(), _pool.get());
+        if(d1 < d0)
+        {
+            c0.swap(c1);
+            d0 = d1;
+            d2f_s_ptr->set_coefficients(c0);
+            n_accepted++;
+            i_lr = 0;
+        }
+        else
+        {
+            i_lr++;
+            if(i_lr % 100 == 0)
+                lr *= 0.9;
+        }
+    }
+
+    finish_cancel(i, m);
+    stop_pipeline();
+    if(_control)
+        _control->publish(i, n_accepted, d0, lr, c0, false, _overlap_gain);
+    d2f_s_ptr->set_coefficients(c0);
+    return D2Fourier2D(*d2f_s_ptr);
+}
+
+void StochasticSolver::cancel()
+{
+    _cancel = true;
+}
+
+bool StochasticSolver::cancelled() const
+{
+    return _cancelled;
+}
+
+void StochasticSolver::finish_cancel(int i, int m)
+{
+    _cancelled = _cancel && i < m;
+    _cancel = false;
+}
+
+void StochasticSolver::set_control(std::shared_ptr<SolverControl> control)
+{
+    _control = control;
+}
+
+bool StochasticSolver::poll(long i, long n_accepted, double d, double& lr, const std::vector<double>& c)
+{
+    double lr_new = _control->take_lr();
+    if(!std::isnan(lr_new))
+        lr = lr_new;
+    _control->publish(i, n_accepted, d, lr, c, true, overlap_gain());
+    while(_control->pause_requested() && !_control->stop_requested() && !_cancel)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        lr_new = _control->take_lr();
+        if(!std::isnan(lr_new))
+        {
+            lr = lr_new;
+            _control->publish(i, n_accepted, d, lr, c, true, overlap_gain());
+        }
+    }
+    return _control->stop_requested();
+}
+
+void StochasticSolver::set_thread_pool(std::shared_ptr<ThreadPool> pool)
+{
+    _pool = pool;
+}
+
+void StochasticSolver::set_pipeline(int depth)
+{
+    _pipeline_depth = depth;
+}
+
+double StochasticSolver::overlap_gain() const
+{
+    return _pipeline ? _pipeline->overlap_gain() : _overlap_gain;
+}
+
+void StochasticSolver::start_pipeline(std::vector<int> sizes)
+{
+    _overlap_gain = 0.0;
+    if(_pipeline_depth > 0)
+        _pipeline = std::make_unique<ProposalPipeline>(_gen, _dist, sizes, _pipeline_depth);
+}
+
+void StochasticSolver::stop_pipeline()
+{
+    if(!_pipeline)
+        return;
+    _pipeline->stop();
+    _overlap_gain = _pipeline->overlap_gain();
+    _pipeline.reset();
+}
+
 std::vector<double> StochasticSolver::step(int n, double lr)
 {
     std::vector<double> dc(n);
@@ -74,4 +418,12 @@ std::vector<double> StochasticSolver::step(int n, double lr)
         dc.begin(), [lr, norm](double d){ return lr * d/norm; }
     );
     return dc;
+}
+
+void StochasticSolver::step(int n, double lr, std::vector<double>& dc)
+{
+    if(_pipeline)
+        _pipeline->pop(lr, dc);
+    else
+        dc = step(n, lr);
 }
\ No newline at end of file
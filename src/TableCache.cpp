@@ -0,0 +1,233 @@
+//
+//  TableCache.cpp
+//
+
+#include <algorithm> // std::copy, std::fill
+#include <cstdio> // std::rename, std::remove, fdopen
+#include <cstdlib> // mkstemp
+#include <cstring> // std::memcmp, std::memcpy, std::memset, std::strncpy
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "TableCache.hpp"
+
+
+namespace
+{
+    const char magic[8] = {'S', 'F', 'S', 'T', 'A', 'B', 'L', 'E'};
+    const uint32_t kind_basis = 0;
+    const uint32_t kind_samples = 1;
+    const uint32_t rule_riemann = 0; // centered Riemann rule, see MathUtil::Integrator::simple
+    const size_t header_size = 4096; // tables start page aligned
+
+    // File header, followed by the tables at offset header_size
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t kind; // kind_basis or kind_samples
+        uint32_t rule; // quadrature rule
+        uint32_t precision; // bits per table value
+        int64_t n; // number of modes
+        int64_t N; // number of intervals
+        double a; // lower boundary
+        double b; // upper boundary
+        uint64_t name_hash; // hash of target name (samples only)
+        uint64_t payload_bytes; // size of tables
+        uint64_t checksum; // checksum of tables
+        char name[256]; // target name (samples only)
+    };
+    static_assert(sizeof(Header) <= header_size, "header too large");
+
+    // 64-bit FNV-1a hash of a string
+    uint64_t hash(const std::string& s)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for(unsigned char ch : s)
+        {
+            h = (h ^ ch) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Checksum of the tables, FNV-1a over 64-bit words
+    uint64_t checksum(const double* v, size_t n)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for(size_t i = 0; i < n; i++)
+        {
+            uint64_t w;
+            std::memcpy(&w, &v[i], sizeof(w));
+            h = (h ^ w) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Read-only mapping of a whole file, unmapped on destruction
+    struct Mapping
+    {
+        Mapping(void* data, size_t size) : data(data), size(size) {}
+        ~Mapping()
+        {
+            munmap(data, size);
+        }
+        void* data;
+        size_t size;
+    };
+
+    Header make_header(uint32_t kind, int n, int N, double a, double b, const std::string& name)
+    {
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, magic, sizeof(magic));
+        h.version = TableCache::version;
+        h.kind = kind;
+        h.rule = rule_riemann;
+        h.precision = 8 * sizeof(double);
+        h.n = n;
+        h.N = N;
+        h.a = a;
+        h.b = b;
+        h.name_hash = hash(name);
+        std::strncpy(h.name, name.c_str(), sizeof(h.name) - 1);
+        return h;
+    }
+
+    // Map file at path, if its header matches key and its tables
+    // have the expected size (and checksum); nullptr otherwise.
+    std::shared_ptr<Mapping> load(const std::string& path, const Header& key, size_t n_values, bool verify)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            return nullptr;
+        struct stat st;
+        size_t size = header_size + n_values * sizeof(double);
+        if(fstat(fd, &st) != 0 || (size_t)st.st_size != size)
+        {
+            close(fd);
+            return nullptr;
+        }
+        void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if(data == MAP_FAILED)
+            return nullptr;
+        std::shared_ptr<Mapping> mapping = std::make_shared<Mapping>(data, size);
+
+        const Header* h = static_cast<const Header*>(data);
+        const double* values = reinterpret_cast<const double*>(static_cast<const char*>(data) + header_size);
+        if(std::memcmp(h->magic, key.magic, sizeof(h->magic)) != 0 ||
+           h->version != key.version || h->kind != key.kind ||
+           h->rule != key.rule || h->precision != key.precision ||
+           h->n != key.n || h->N != key.N || h->a != key.a || h->b != key.b ||
+           h->name_hash != key.name_hash ||
+           std::strncmp(h->name, key.name, sizeof(h->name)) != 0 ||
+           h->payload_bytes != n_values * sizeof(double))
+            return nullptr;
+        if(verify && h->checksum != checksum(values, n_values))
+            return nullptr;
+        return mapping;
+    }
+
+    // Write header and tables to a temporary file and rename it to path.
+    // The temporary file has a unique name (mkstemp), so concurrent
+    // stores of the same key, even within one process, do not interfere.
+    void store(const std::string& path, Header h, const double* values, size_t n_values)
+    {
+        h.payload_bytes = n_values * sizeof(double);
+        h.checksum = checksum(values, n_values);
+        std::vector<char> header(header_size, 0);
+        std::memcpy(header.data(), &h, sizeof(h));
+
+        std::vector<char> tmp(path.begin(), path.end());
+        const char suffix[] = ".tmp.XXXXXX";
+        tmp.insert(tmp.end(), suffix, suffix + sizeof(suffix));
+        int fd = mkstemp(tmp.data());
+        if(fd < 0)
+            return;
+        fchmod(fd, 0644);
+        FILE* file = fdopen(fd, "wb");
+        if(!file)
+        {
+            close(fd);
+            std::remove(tmp.data());
+            return;
+        }
+        bool ok = fwrite(header.data(), 1, header_size, file) == header_size &&
+                  fwrite(values, sizeof(double), n_values, file) == n_values;
+        ok = (fclose(file) == 0) && ok;
+        if(!ok || std::rename(tmp.data(), path.c_str()) != 0)
+            std::remove(tmp.data());
+    }
+}
+
+TableCache::TableCache(std::string directory, bool verify) : _directory(directory), _verify(verify)
+{
+    mkdir(_directory.c_str(), 0755);
+}
+
+std::shared_ptr<const CosineBasis> TableCache::basis(int n, int N, double a, double b)
+{
+    std::string file = path("basis", n, N, a, b, 0);
+    Header key = make_header(kind_basis, n, N, a, b, "");
+    // Tables: nodes (N), weights (N), modes (n*N)
+    size_t n_values = 2 * (size_t)N + (size_t)n * N;
+
+    std::shared_ptr<Mapping> mapping = load(file, key, n_values, _verify);
+    if(!mapping)
+    {
+        CosineBasis computed(n, N, a, b);
+        std::vector<double> values(n_values);
+        std::copy(computed.nodes(), computed.nodes() + N, values.begin());
+        std::fill(values.begin() + N, values.begin() + 2 * N, computed.dx());
+        std::copy(computed.column(0), computed.column(0) + (size_t)n * N, values.begin() + 2 * N);
+        store(file, key, values.data(), n_values);
+        mapping = load(file, key, n_values, true);
+        if(!mapping)
+            return std::make_shared<const CosineBasis>(computed);
+    }
+    const double* values = reinterpret_cast<const double*>(static_cast<const char*>(mapping->data) + header_size);
+    return std::shared_ptr<const CosineBasis>(new CosineBasis(n, N, a, b, mapping, values, values + 2 * N));
+}
+
+std::shared_ptr<const double> TableCache::samples(const std::string& name, const CosineBasis& basis,
+                                                  const Function& f)
+{
+    // Samples only depend on the nodes, hence n is not part of the key
+    int N = basis.N();
+    std::string file = path("samples", 0, N, basis.a(), basis.b(), hash(name));
+    Header key = make_header(kind_samples, 0, N, basis.a(), basis.b(), name);
+
+    std::shared_ptr<Mapping> mapping;
+    if(name.size() < sizeof(key.name))
+        mapping = load(file, key, N, _verify);
+    if(!mapping)
+    {
+        std::shared_ptr<std::vector<double>> g = std::make_shared<std::vector<double>>(basis.sample(f));
+        if(name.size() < sizeof(key.name))
+        {
+            store(file, key, g->data(), N);
+            mapping = load(file, key, N, true);
+        }
+        if(!mapping)
+            return std::shared_ptr<const double>(g, g->data());
+    }
+    const double* values = reinterpret_cast<const double*>(static_cast<const char*>(mapping->data) + header_size);
+    return std::shared_ptr<const double>(mapping, values);
+}
+
+std::string TableCache::path(const std::string& kind, int n, int N, double a, double b, uint64_t name_hash) const
+{
+    // Boundaries by their bit patterns, so that the key is exact
+    uint64_t a_bits;
+    uint64_t b_bits;
+    std::memcpy(&a_bits, &a, sizeof(a));
+    std::memcpy(&b_bits, &b, sizeof(b));
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s_n%d_N%d_a%016llx_b%016llx_r%u_p%u_h%016llx.v%u.sfs",
+             kind.c_str(), n, N, (unsigned long long)a_bits, (unsigned long long)b_bits,
+             rule_riemann, (unsigned)(8 * sizeof(double)), (unsigned long long)name_hash, version);
+    return _directory + "/" + buf;
+}
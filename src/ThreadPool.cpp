@@ -0,0 +1,97 @@
+//
+//  ThreadPool.cpp
+//
+
+#include "ThreadPool.hpp"
+
+
+ThreadPool::ThreadPool(int num_threads) :
+    _task(nullptr), _n_tasks(0), _next(0), _pending(0), _generation(0), _stop(false)
+{
+    for(int i = 1; i < num_threads; i++)
+    {
+        _threads.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _stop = true;
+    }
+    _cv_start.notify_all();
+    for(std::thread& t : _threads)
+    {
+        t.join();
+    }
+}
+
+int ThreadPool::size() const
+{
+    return _threads.size() + 1;
+}
+
+void ThreadPool::parallel_for(int n, const std::function<void(int)>& task)
+{
+    if(n <= 0)
+        return;
+    if(_threads.empty() || n == 1)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    // One job at a time; a second caller waits until the first is done
+    std::lock_guard<std::mutex> job_lock(_job_mtx);
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _task = &task;
+        _n_tasks = n;
+        _next = 0;
+        _pending = n;
+        _generation++;
+    }
+    _cv_start.notify_all();
+
+    // The calling thread takes part in the job as well
+    run_tasks();
+
+    std::unique_lock<std::mutex> lock(_mtx);
+    _cv_done.wait(lock, [this]{ return _pending == 0; });
+    _task = nullptr;
+}
+
+void ThreadPool::work()
+{
+    unsigned long seen = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mtx);
+            _cv_start.wait(lock, [this, seen]{ return _stop || _generation != seen; });
+            if(_stop)
+                return;
+            seen = _generation;
+        }
+        run_tasks();
+    }
+}
+
+void ThreadPool::run_tasks()
+{
+    std::unique_lock<std::mutex> lock(_mtx);
+    while(_task && _next < _n_tasks)
+    {
+        int i = _next++;
+        const std::function<void(int)>* task = _task;
+        lock.unlock();
+        (*task)(i);
+        lock.lock();
+        if(--_pending == 0)
+            _cv_done.notify_all();
+    }
+}
@@ -0,0 +1,222 @@
+// Benchmark of the different solve paths of StochasticSolver
+// for the default configuration of main.cpp (n = 10, N = 100).
+// All solvers use the same seed and number of iterations, and all
+// solves evaluate one distance per iteration.
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread> // std::thread::hardware_concurrency
+
+#include "BatchSolver.hpp"
+#include "CosineBasis.hpp"
+#include "D2Fourier.hpp"
+#include "D2FourierFixed.hpp"
+#include "D2Gauss.hpp"
+#include "MathUtil.hpp"
+#include "StochasticSolver.hpp"
+
+
+// Helper functions
+template <typename T>
+double measure(T&&);
+
+int main()
+{
+    std::shared_ptr<D2Gauss> g_s_ptr = std::make_shared<D2Gauss>(1.0, 4.0, 0.0);
+    unsigned int seed = 1234u;
+    const int m = 2e4; // number of iterations in solver
+    const int n = 10; // number of Fourier-(cos)coefficients
+    const int N = 100; // number of discrete intervals for numeric integration
+    double lr = 1e-4;
+
+    double d_dynamic = 0.0;
+    double t_dynamic = measure([&]()
+    {
+        StochasticSolver solver(seed);
+        std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n));
+        D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, n, N, lr);
+        d_dynamic = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N);
+    });
+
+    double d_fixed = 0.0;
+    double t_fixed = measure([&]()
+    {
+        StochasticSolver solver(seed);
+        std::shared_ptr<D2FourierFixed<n>> d2f_s_ptr = std::make_shared<D2FourierFixed<n>>();
+        D2FourierFixed<n> d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, N, lr);
+        d_fixed = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N);
+    });
+
+    double d_basis = 0.0;
+    double t_basis = measure([&]()
+    {
+        StochasticSolver solver(seed);
+        CosineBasis basis(n, N, -M_PI, M_PI);
+        std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n));
+        D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, basis, lr);
+        d_basis = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N);
+    });
+
+    // Distance kernel alone, i.e. one Distance::L2 per iteration as in
+    // every solve above, without the proposal and acceptance logic.
+    std::vector<double> c_kernel(n);
+    std::array<double, n> c_kernel_fixed;
+    for(int k = 0; k < n; k++)
+    {
+        c_kernel[k] = c_kernel_fixed[k] = 0.1 / (k + 1);
+    }
+    double s_dynamic = 0.0;
+    double t_kernel_dynamic = measure([&]()
+    {
+        D2Fourier d2f(c_kernel);
+        for(int i = 0; i < m; i++)
+            s_dynamic += MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N);
+    });
+    double s_fixed = 0.0;
+    double t_kernel_fixed = measure([&]()
+    {
+        D2FourierFixed<n> d2f;
+        d2f.set_coefficients(c_kernel_fixed);
+        for(int i = 0; i < m; i++)
+            s_fixed += MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N);
+    });
+
+    std::cout << "n = " << n << ", N = " << N << ", m = " << m << std::endl;
+    std::cout << "Distance::L2 x m, D2Fourier:          " << t_kernel_dynamic << " s" << std::endl;
+    std::cout << "Distance::L2 x m, D2FourierFixed<" << n << ">:  " << t_kernel_fixed << " s, speedup "
+              << t_kernel_dynamic / t_kernel_fixed << (s_dynamic == s_fixed ? "" : " (sums differ!)") << std::endl;
+    std::cout << "D2Fourier:           " << t_dynamic << " s, distance " << d_dynamic << std::endl;
+    std::cout << "D2FourierFixed<" << n << ">:  " << t_fixed << " s, distance " << d_fixed
+              << ", speedup " << t_dynamic / t_fixed << std::endl;
+    std::cout << "CosineBasis:         " << t_basis << " s, distance " << d_basis
+              << ", speedup " << t_dynamic / t_basis << std::endl;
+
+    // Block-coordinate mode pays off for larger n, where full-vector
+    // proposals are dominated by the high modes and mostly rejected.
+    const int n_large = 64;
+    const int N_large = 1000;
+    const int block = 4;
+    CosineBasis basis_large(n_large, N_large, -M_PI, M_PI);
+
+    double d_full = 0.0;
+    double t_full = measure([&]()
+    {
+        StochasticSolver solver(seed);
+        std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n_large));
+        D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, basis_large, lr);
+        d_full = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N_large);
+    });
+
+    double d_block = 0.0;
+    double t_block = measure([&]()
+    {
+        StochasticSolver solver(seed);
+        std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n_large));
+        std::vector<int> blocks(n_large / block, block);
+        std::vector<double> lr_blocks(blocks.size(), lr);
+        D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, basis_large, blocks, lr_blocks);
+        d_block = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N_large);
+    });
+
+    std::cout << std::endl;
+    std::cout << "n = " << n_large << ", N = " << N_large << ", m = " << m << std::endl;
+    std::cout << "CosineBasis:         " << t_full << " s, distance " << d_full << std::endl;
+    std::cout << "Blocks of " << block << ":         " << t_block << " s, distance " << d_block
+              << ", speedup " << t_full / t_block << std::endl;
+
+    // Pipelined mode overlaps drawing and normalizing the steps with the
+    // distance evaluation; it matters where the evaluation is cheap
+    // compared to the step, i.e. for moderate N. Results are identical.
+    const int N_small = 100;
+    const int depth = 64;
+    CosineBasis basis_small(n_large, N_small, -M_PI, M_PI);
+
+    double d_serial = 0.0;
+    double t_serial = measure([&]()
+    {
+        StochasticSolver solver(seed);
+        std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n_large));
+        D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, basis_small, lr);
+        d_serial = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N_small);
+    });
+
+    double d_pipelined = 0.0;
+    double overlap = 0.0;
+    double t_pipelined = measure([&]()
+    {
+        StochasticSolver solver(seed);
+        solver.set_pipeline(depth);
+        std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n_large));
+        D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, basis_small, lr);
+        d_pipelined = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N_small);
+        overlap = solver.overlap_gain();
+    });
+
+    std::cout << std::endl;
+    std::cout << "n = " << n_large << ", N = " << N_small << ", m = " << m
+              << ", hardware threads = " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "CosineBasis:         " << t_serial << " s, distance " << d_serial << std::endl;
+    std::cout << "Pipelined (" << depth << "):      " << t_pipelined << " s, distance " << d_pipelined
+              << ", speedup " << t_serial / t_pipelined << ", overlap gain " << overlap << " s" << std::endl;
+
+    // BatchSolver advances B targets in lockstep on one basis and has to
+    // match B separate solves with seeds seed + b bitwise.
+    const int B = 64;
+    const int m_batch = 200;
+    std::vector<std::shared_ptr<D2Gauss>> g_batch;
+    for(int b = 0; b < B; b++)
+    {
+        g_batch.push_back(std::make_shared<D2Gauss>(1.0, 2.0 + 4.0 * b / B, 0.0));
+    }
+    std::cout << std::endl;
+    std::cout << "n = " << n << ", B = " << B << ", m = " << m_batch << std::endl;
+    for(int N_batch : {100, 1000, 10000, 100000})
+    {
+        CosineBasis basis_batch(n, N_batch, -M_PI, M_PI);
+
+        std::vector<std::vector<double>> c_separate(B);
+        double t_separate = measure([&]()
+        {
+            for(int b = 0; b < B; b++)
+            {
+                StochasticSolver solver(seed + b);
+                std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n));
+                c_separate[b] = solver.solve(d2f_s_ptr, g_batch[b], m_batch, basis_batch, lr).get_coefficients();
+            }
+        });
+
+        std::vector<D2Fourier> res;
+        double t_batch = measure([&]()
+        {
+            BatchSolver solver(seed);
+            std::vector<std::shared_ptr<D2Fourier>> d2f_batch;
+            for(int b = 0; b < B; b++)
+            {
+                d2f_batch.push_back(std::make_shared<D2Fourier>(std::vector<double>(n)));
+            }
+            res = solver.solve(d2f_batch, g_batch, m_batch, basis_batch, lr);
+        });
+
+        bool identical = true;
+        for(int b = 0; b < B; b++)
+        {
+            identical = identical && res[b].get_coefficients() == c_separate[b];
+        }
+        std::cout << "N = " << N_batch << ": " << B << " x StochasticSolver " << t_separate << " s, BatchSolver "
+                  << t_batch << " s, speedup " << t_separate / t_batch
+                  << (identical ? ", identical results" : ", results DIFFER") << std::endl;
+    }
+
+    return 0;
+}
+
+template <typename T>
+double measure(T&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
@@ -7,21 +7,26 @@
 // g(x) is the second derivative of a Gaussian.
 // Takes ~10 seconds with standard settings.
 
+#include <cstdlib> // std::getenv
 #include <iostream>
 #include <thread>
 
+#include "ControlServer.hpp"
 #include "D2Fourier.hpp"
 #include "D2Gauss.hpp"
+#include "EnsembleViewer.hpp"
 #include "Fourier.hpp"
 #include "Gauss.hpp"
 #include "GnuplotFunctionViewer.hpp"
 #include "MathUtil.hpp"
+#include "SolverControl.hpp"
 #include "StochasticSolver.hpp"
 
 
 // Helper functions
 template <typename T>
 void print_vector(const std::vector<T>&);
+int run_ensemble(int, std::shared_ptr<D2Gauss>, unsigned int, int, int, int, double);
 
 // We don't parse command line arguments since I neither like
 // getopt nor boost::program_options ...
@@ -45,6 +50,12 @@ int main()
     const int N = 100; // number of discrete intervals for numeric integration
     double lr = 1e-4; // use smaller lr for nicer animation
 
+    // If SFS_ENSEMBLE names a number of runs, solve that many seeds
+    // concurrently and monitor them all in one gnuplot window instead.
+    const char* ensemble = std::getenv("SFS_ENSEMBLE");
+    if(ensemble && std::atoi(ensemble) > 0)
+        return run_ensemble(std::atoi(ensemble), g_s_ptr, seed, m, n, N, lr);
+
     // Create shared pointer of D2Fourier object representing f''(x),
     // initialized with an coefficients zero.
     std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n));
@@ -60,9 +71,29 @@ int main()
     // plotting the current version of the functions.
     std::thread t = std::thread(&GnuplotFunctionViewer::operator(), &gnuplot_viewer);
 
+    // If SFS_CONTROL_SOCKET names a socket path, start a third thread
+    // which lets local clients query and steer the solver through it.
+    const char* control_path = std::getenv("SFS_CONTROL_SOCKET");
+    std::shared_ptr<ControlServer> control_server;
+    std::thread t_control;
+    if(control_path)
+    {
+        std::shared_ptr<SolverControl> control = std::make_shared<SolverControl>();
+        solver.set_control(control);
+        control_server = std::make_shared<ControlServer>(control_path, control);
+        t_control = std::thread(&ControlServer::operator(), control_server);
+    }
+
     // Start solver, get solved D2Fourier object
     D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, n, N, lr);
 
+    // Stop control thread, if any
+    if(control_server)
+    {
+        control_server->stop();
+        t_control.join();
+    }
+
     // Give signal to stop plotting,
     gnuplot_viewer.stop();
 
@@ -77,6 +108,35 @@ int main()
     return 0;
 }
 
+int run_ensemble(int runs, std::shared_ptr<D2Gauss> g_s_ptr, unsigned int seed, int m, int n, int N, double lr)
+{
+    EnsembleViewer viewer;
+    std::vector<std::thread> threads;
+    std::vector<double> distances(runs);
+    for(int r = 0; r < runs; r++)
+    {
+        std::shared_ptr<SolverControl> control = std::make_shared<SolverControl>();
+        viewer.add("seed " + std::to_string(seed + r), control, g_s_ptr);
+        threads.emplace_back([=, &distances]()
+        {
+            StochasticSolver solver(seed + r);
+            solver.set_control(control);
+            std::shared_ptr<D2Fourier> d2f_s_ptr = std::make_shared<D2Fourier>(std::vector<double>(n));
+            D2Fourier d2f = solver.solve(d2f_s_ptr, g_s_ptr, m, n, N, lr);
+            distances[r] = MathUtil::Distance::L2(d2f, *g_s_ptr, -M_PI, M_PI, N);
+        });
+    }
+    std::thread t = std::thread(&EnsembleViewer::operator(), &viewer);
+    for(std::thread& thread : threads)
+        thread.join();
+    viewer.stop();
+    t.join();
+
+    std::cout << "Final distances: " << std::endl;
+    print_vector(distances);
+    return 0;
+}
+
 template <typename T>
 void print_vector(const std::vector<T>& vector)
 {
@@ -0,0 +1,228 @@
+//
+//  sfsolver.cpp
+//
+
+#include <algorithm> // std::copy
+#include <cmath>
+#include <cstdio> // snprintf
+#include <memory>
+#include <new> // std::bad_alloc
+#include <vector>
+
+#include "CosineBasis.hpp"
+#include "D2Fourier.hpp"
+#include "D2Gauss.hpp"
+#include "LinearOperator.hpp"
+#include "StochasticSolver.hpp"
+#include "TableCache.hpp"
+#include "ThreadPool.hpp"
+#include "sfsolver.h"
+
+
+struct sfs_handle
+{
+    sfs_handle(unsigned int seed, int num_threads) :
+        solver(seed), pool(std::make_shared<ThreadPool>(num_threads)), basis_stale(false), distance(-1.0)
+    {
+        solver.set_thread_pool(pool);
+    }
+
+    StochasticSolver solver; // solver, keeps its random engine between solves
+    std::shared_ptr<ThreadPool> pool; // persistent thread pool
+    std::unique_ptr<TableCache> cache; // optional on-disk cache of basis tables and samples
+    std::shared_ptr<const CosineBasis> basis; // basis table, rebuilt only if n or N change
+    bool basis_stale; // basis_stale == true -> rebuild basis with next sfs_set_problem
+    LinearOperator op; // operator L of L f = g
+    std::shared_ptr<D2Gauss> g; // RHS g(x)
+    std::shared_ptr<const double> samples; // g(x_i) at the nodes of basis
+    std::shared_ptr<D2Fourier> d2f; // current solution f''(x)
+    double distance; // L2 distance of current coefficients
+};
+
+namespace
+{
+    // L2 distance of the current coefficients of h on its basis
+    double distance(const sfs_handle* h)
+    {
+        const CosineBasis& basis = *h->basis;
+        std::vector<double> c = h->d2f->get_coefficients();
+        std::vector<double> w(basis.n());
+        std::vector<double> r(basis.N());
+        const std::vector<double>& lambda = h->d2f->get_multipliers();
+        for(int k = 0; k < basis.n(); k++)
+        {
+            w[k] = c[k] * lambda[k];
+        }
+        basis.residual(w.data(), h->samples.get(), r.data(), h->pool.get());
+        return basis.l2(r.data(), h->pool.get());
+    }
+
+    // Samples of the RHS of h at the nodes of its basis, mapped from the
+    // cache if enabled. The cache key holds the exact D2Gauss parameters.
+    std::shared_ptr<const double> samples(const sfs_handle* h, double a, double k, double x0)
+    {
+        if(h->cache)
+        {
+            char name[128];
+            snprintf(name, sizeof(name), "D2Gauss a=%a k=%a x0=%a", a, k, x0);
+            return h->cache->samples(name, *h->basis, *h->g);
+        }
+        std::shared_ptr<std::vector<double>> g =
+            std::make_shared<std::vector<double>>(h->basis->sample(*h->g));
+        return std::shared_ptr<const double>(g, g->data());
+    }
+}
+
+extern "C"
+{
+
+sfs_handle* sfs_create(unsigned int seed, int num_threads)
+{
+    if(num_threads < 1)
+        return nullptr;
+    try
+    {
+        return new sfs_handle(seed, num_threads);
+    }
+    catch(...)
+    {
+        return nullptr;
+    }
+}
+
+void sfs_destroy(sfs_handle* h)
+{
+    delete h;
+}
+
+int sfs_set_cache_dir(sfs_handle* h, const char* dir)
+{
+    if(!h)
+        return SFS_ERR_ARG;
+    try
+    {
+        h->cache.reset();
+        if(dir)
+            h->cache = std::make_unique<TableCache>(dir);
+        // Pick up the cache with the next sfs_set_problem,
+        // the current problem keeps its basis until then
+        h->basis_stale = true;
+    }
+    catch(const std::bad_alloc&)
+    {
+        return SFS_ERR_ALLOC;
+    }
+    return SFS_OK;
+}
+
+int sfs_set_problem(sfs_handle* h, double a, double k, double x0, int n, int N)
+{
+    if(!h || n < 1 || N < 1)
+        return SFS_ERR_ARG;
+    try
+    {
+        if(!h->basis || h->basis_stale || h->basis->n() != n || h->basis->N() != N)
+        {
+            h->basis_stale = false;
+            h->basis.reset();
+            if(h->cache)
+                h->basis = h->cache->basis(n, N, -M_PI, M_PI);
+            else
+                h->basis = std::make_shared<const CosineBasis>(n, N, -M_PI, M_PI);
+        }
+        h->g = std::make_shared<D2Gauss>(a, k, x0);
+        h->samples = samples(h, a, k, x0);
+        h->d2f = std::make_shared<D2Fourier>(std::vector<double>(n), h->op);
+        h->distance = distance(h);
+    }
+    catch(const std::bad_alloc&)
+    {
+        h->basis.reset();
+        return SFS_ERR_ALLOC;
+    }
+    return SFS_OK;
+}
+
+int sfs_set_operator(sfs_handle* h, const double* a, int len)
+{
+    if(!h || !a || len < 1)
+        return SFS_ERR_ARG;
+    try
+    {
+        h->op = LinearOperator(std::vector<double>(a, a + len));
+        if(h->d2f)
+        {
+            h->d2f = std::make_shared<D2Fourier>(h->d2f->get_coefficients(), h->op);
+            h->distance = distance(h);
+        }
+    }
+    catch(const std::bad_alloc&)
+    {
+        return SFS_ERR_ALLOC;
+    }
+    return SFS_OK;
+}
+
+int sfs_set_coefficients(sfs_handle* h, const double* c, int n)
+{
+    if(!h || !c)
+        return SFS_ERR_ARG;
+    if(!h->basis || !h->d2f)
+        return SFS_ERR_STATE;
+    if(n != h->basis->n())
+        return SFS_ERR_ARG;
+    try
+    {
+        h->d2f->set_coefficients(std::vector<double>(c, c + n));
+        h->distance = distance(h);
+    }
+    catch(const std::bad_alloc&)
+    {
+        return SFS_ERR_ALLOC;
+    }
+    return SFS_OK;
+}
+
+int sfs_solve(sfs_handle* h, int m, double lr)
+{
+    if(!h || m < 0 || !(lr > 0.0))
+        return SFS_ERR_ARG;
+    if(!h->basis || !h->d2f)
+        return SFS_ERR_STATE;
+    try
+    {
+        h->solver.solve(h->d2f, h->samples.get(), m, *h->basis, lr);
+        h->distance = distance(h);
+    }
+    catch(const std::bad_alloc&)
+    {
+        return SFS_ERR_ALLOC;
+    }
+    return h->solver.cancelled() ? SFS_CANCELLED : SFS_OK;
+}
+
+void sfs_cancel(sfs_handle* h)
+{
+    if(h)
+        h->solver.cancel();
+}
+
+int sfs_get_coefficients(const sfs_handle* h, double* out, int len)
+{
+    if(!h || !out)
+        return SFS_ERR_ARG;
+    if(!h->d2f)
+        return SFS_ERR_STATE;
+    std::vector<double> c = h->d2f->get_coefficients();
+    if(len < (int)c.size())
+        return SFS_ERR_ARG;
+    std::copy(c.begin(), c.end(), out);
+    return c.size();
+}
+
+double sfs_get_distance(const sfs_handle* h)
+{
+    return h && h->d2f ? h->distance : -1.0;
+}
+
+}